@@ -0,0 +1,94 @@
+#include "zedio/core.hpp"
+#include "zedio/log.hpp"
+#include "zedio/net.hpp"
+#include "zedio/sync.hpp"
+
+// C++
+#include <chrono>
+#include <string>
+#include <string_view>
+
+using namespace zedio::async;
+using namespace zedio::net;
+using namespace zedio::sync;
+using namespace zedio::log;
+using namespace zedio;
+
+// A connection storm: every client task connects and hangs up in a loop, the
+// server accepts with one accept per connection or with a multishot accept.
+auto client(const SocketAddr &addr, std::size_t num_connections, Latch &latch) -> Task<void> {
+    for (auto i = 0uz; i < num_connections; ++i) {
+        auto ret = co_await TcpStream::connect(addr);
+        if (!ret) {
+            console.error("connect failed: {}", ret.error().message());
+            break;
+        }
+        co_await ret.value().close();
+    }
+    latch.count_down();
+}
+
+auto serve_accept(TcpListener &listener, std::size_t total) -> Task<void> {
+    for (auto i = 0uz; i < total; ++i) {
+        auto ret = co_await listener.accept();
+        if (!ret) {
+            console.error("accept failed: {}", ret.error().message());
+            break;
+        }
+    }
+}
+
+auto serve_incoming(TcpListener &listener, std::size_t total) -> Task<void> {
+    auto incoming = listener.incoming();
+    for (auto i = 0uz; i < total; ++i) {
+        auto ret = co_await incoming.next();
+        if (!ret) {
+            console.error("accept failed: {}", ret.error().message());
+            break;
+        }
+    }
+}
+
+auto main_loop(std::string_view mode, std::size_t num_clients, std::size_t num_connections)
+    -> Task<void> {
+    auto addr = SocketAddr::parse("127.0.0.1", 9797).value();
+    auto ret = TcpListener::bind(addr);
+    if (!ret) {
+        console.error("{}", ret.error().message());
+        co_return;
+    }
+    auto  listener = std::move(ret.value());
+    auto  total = num_clients * num_connections;
+    Latch latch{static_cast<std::ptrdiff_t>(num_clients)};
+    auto  start = std::chrono::steady_clock::now();
+    for (auto i = 0uz; i < num_clients; ++i) {
+        spawn(client(addr, num_connections, latch));
+    }
+    if (mode == "incoming") {
+        co_await serve_incoming(listener, total);
+    } else {
+        co_await serve_accept(listener, total);
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+    co_await latch.wait();
+    console.info("{:>8}: {} connections in {:.3f}s, {:.0f} accepts/s",
+                 mode,
+                 total,
+                 elapsed.count(),
+                 static_cast<double>(total) / elapsed.count());
+    co_await listener.close();
+}
+
+auto main(int argc, char **argv) -> int {
+    if (argc > 3) {
+        std::cerr << "usage: accept_benchmark [num_clients] [num_connections]\n";
+        return -1;
+    }
+    std::size_t num_clients = argc > 1 ? std::stoul(argv[1]) : 64;
+    std::size_t num_connections = argc > 2 ? std::stoul(argv[2]) : 256;
+    for (auto mode : {"accept", "incoming"}) {
+        runtime::MultiThreadBuilder::default_create().block_on(
+            main_loop(mode, num_clients, num_connections));
+    }
+    return 0;
+}
@@ -68,14 +68,24 @@ auto main(int argc, char **argv) -> int {
     }
     SET_LOG_LEVEL(zedio::log::LogLevel::Trace);
     auto num_threads = std::stoi(argv[1]);
+    auto report = [](const runtime::detail::SubmitStats &stats) {
+        console.info("{} submits, {} sqes, {} submit syscalls, {} syscalls saved",
+                     stats.num_requests_,
+                     stats.num_sqes_,
+                     stats.num_syscalls_,
+                     stats.num_syscalls_saved());
+    };
     if (num_threads > 1) {
-        runtime::MultiThreadBuilder::options()
-            .set_num_workers(num_threads)
-            .set_submit_interval(0)
-            .build()
-            .block_on(main_loop());
+        auto rt = runtime::MultiThreadBuilder::options()
+                      .set_num_workers(num_threads)
+                      .set_submit_interval(0)
+                      .build();
+        rt.block_on(main_loop());
+        report(rt.stats());
     } else {
-        runtime::CurrentThreadBuilder::default_create().block_on(main_loop());
+        auto rt = runtime::CurrentThreadBuilder::default_create();
+        rt.block_on(main_loop());
+        report(rt.stats());
     }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "zedio/core.hpp"
+#include "zedio/log.hpp"
+#include "zedio/sync.hpp"
+
+// C++
+#include <chrono>
+#include <string>
+
+using namespace zedio::async;
+using namespace zedio::sync;
+using namespace zedio::log;
+using namespace zedio;
+
+// Each fan-out task spawns a burst of leaf tasks, so the local queue of the
+// spawning worker overflows to the global queue and idle workers steal from it.
+auto leaf(Latch &latch) -> Task<void> {
+    latch.count_down();
+    co_return;
+}
+
+auto fan_out(Latch &latch, std::size_t num_leaves) -> Task<void> {
+    for (auto i = 0uz; i < num_leaves; ++i) {
+        spawn(leaf(latch));
+    }
+    co_return;
+}
+
+auto main_loop(std::size_t num_fan_outs, std::size_t num_leaves, std::size_t capacity)
+    -> Task<void> {
+    Latch latch{static_cast<std::ptrdiff_t>(num_fan_outs * num_leaves)};
+    auto  start = std::chrono::steady_clock::now();
+    for (auto i = 0uz; i < num_fan_outs; ++i) {
+        spawn(fan_out(latch, num_leaves));
+    }
+    co_await latch.wait();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+    console.info("capacity: {:>5}, tasks: {}, elapsed: {:.3f}s, throughput: {:.0f} tasks/s",
+                 capacity,
+                 num_fan_outs * num_leaves,
+                 elapsed.count(),
+                 static_cast<double>(num_fan_outs * num_leaves) / elapsed.count());
+}
+
+auto main(int argc, char **argv) -> int {
+    if (argc > 3) {
+        std::cerr << "usage: local_queue_benchmark [num_fan_outs] [num_leaves]\n";
+        return -1;
+    }
+    std::size_t num_fan_outs = argc > 1 ? std::stoul(argv[1]) : 256;
+    std::size_t num_leaves = argc > 2 ? std::stoul(argv[2]) : 1024;
+    for (auto capacity : {64uz, 128uz, 256uz, 512uz, 1024uz, 4096uz}) {
+        runtime::MultiThreadBuilder::options()
+            .set_local_queue_capacity(capacity)
+            .build()
+            .block_on(main_loop(num_fan_outs, num_leaves, capacity));
+    }
+    return 0;
+}
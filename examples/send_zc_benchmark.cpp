@@ -0,0 +1,88 @@
+#include "zedio/core.hpp"
+#include "zedio/log.hpp"
+#include "zedio/net.hpp"
+#include "zedio/sync.hpp"
+
+// C++
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace zedio::async;
+using namespace zedio::net;
+using namespace zedio::sync;
+using namespace zedio::log;
+using namespace zedio;
+
+// The server streams large responses to one client, either copying them into
+// the kernel with write_all or sending them zero copy with write_zc_all
+auto client(const SocketAddr &addr, std::size_t total, Latch &latch) -> Task<void> {
+    auto ret = co_await TcpStream::connect(addr);
+    if (!ret) {
+        console.error("connect failed: {}", ret.error().message());
+        latch.count_down();
+        co_return;
+    }
+    auto              stream = std::move(ret.value());
+    std::vector<char> buf(64 * 1024);
+    std::size_t       received{0};
+    while (received < total) {
+        auto ret = co_await stream.read(buf);
+        if (!ret || ret.value() == 0) {
+            break;
+        }
+        received += ret.value();
+    }
+    latch.count_down();
+}
+
+auto main_loop(std::string_view mode, std::size_t response_size, std::size_t num_responses)
+    -> Task<void> {
+    auto addr = SocketAddr::parse("127.0.0.1", 9896).value();
+    auto has_listener = TcpListener::bind(addr);
+    if (!has_listener) {
+        console.error("{}", has_listener.error().message());
+        co_return;
+    }
+    auto  listener = std::move(has_listener.value());
+    Latch latch{1};
+    spawn(client(addr, response_size * num_responses, latch));
+    auto [stream, peer_addr] = (co_await listener.accept()).value();
+
+    std::vector<char> response(response_size, 'z');
+    auto              start = std::chrono::steady_clock::now();
+    for (auto i = 0uz; i < num_responses; ++i) {
+        auto ret = mode == "write_zc" ? co_await stream.write_zc_all(response)
+                                      : co_await stream.write_all(response);
+        if (!ret) {
+            console.error("{} failed: {}", mode, ret.error().message());
+            break;
+        }
+    }
+    co_await latch.wait();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+    console.info("{:>9}: {} x {} bytes in {:.3f}s, {:.1f} MiB/s",
+                 mode,
+                 num_responses,
+                 response_size,
+                 elapsed.count(),
+                 static_cast<double>(response_size * num_responses) / elapsed.count()
+                     / (1024.0 * 1024.0));
+    co_await stream.close();
+    co_await listener.close();
+}
+
+auto main(int argc, char **argv) -> int {
+    if (argc > 3) {
+        std::cerr << "usage: send_zc_benchmark [response_size] [num_responses]\n";
+        return -1;
+    }
+    std::size_t response_size = argc > 1 ? std::stoul(argv[1]) : 1024 * 1024;
+    std::size_t num_responses = argc > 2 ? std::stoul(argv[2]) : 1024;
+    for (auto mode : {"write_all", "write_zc"}) {
+        runtime::CurrentThreadBuilder::default_create().block_on(
+            main_loop(mode, response_size, num_responses));
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "zedio/core.hpp"
+#include "zedio/log.hpp"
+#include "zedio/net.hpp"
+#include "zedio/time.hpp"
+
+// C++
+#include <chrono>
+#include <string>
+#include <string_view>
+
+using namespace zedio::async;
+using namespace zedio::net;
+using namespace zedio::log;
+using namespace zedio;
+using namespace std::chrono_literals;
+
+// RPC style round trips where every read carries a timeout that never fires,
+// armed either on the timer wheel or as a kernel linked timeout
+auto echo(TcpStream stream) -> Task<void> {
+    char buf[64];
+    while (true) {
+        auto ret = co_await stream.read(buf);
+        if (!ret || ret.value() == 0) {
+            break;
+        }
+        if (auto ret2 = co_await stream.write_all({buf, ret.value()}); !ret2) {
+            break;
+        }
+    }
+}
+
+auto main_loop(std::string_view mode, std::size_t num_requests) -> Task<void> {
+    auto addr = SocketAddr::parse("127.0.0.1", 9795).value();
+    auto has_listener = TcpListener::bind(addr);
+    if (!has_listener) {
+        console.error("{}", has_listener.error().message());
+        co_return;
+    }
+    auto listener = std::move(has_listener.value());
+    auto has_stream = co_await TcpStream::connect(addr);
+    if (!has_stream) {
+        console.error("{}", has_stream.error().message());
+        co_return;
+    }
+    auto client = std::move(has_stream.value());
+    auto [server, peer_addr] = (co_await listener.accept()).value();
+    spawn(echo(std::move(server)));
+
+    std::string_view request = "ping";
+    char             buf[64];
+    auto             start = std::chrono::steady_clock::now();
+    for (auto i = 0uz; i < num_requests; ++i) {
+        if (auto ret = co_await client.write_all(request); !ret) {
+            console.error("write failed: {}", ret.error().message());
+            break;
+        }
+        auto ret = mode == "wheel" ? co_await client.read(buf).set_timeout(1s)
+                                   : co_await client.read(buf).set_link_timeout(1s);
+        if (!ret) {
+            console.error("read failed: {}", ret.error().message());
+            break;
+        }
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+    console.info("{:>5}: {} requests in {:.3f}s, {:.0f} requests/s",
+                 mode,
+                 num_requests,
+                 elapsed.count(),
+                 static_cast<double>(num_requests) / elapsed.count());
+    co_await client.close();
+    co_await listener.close();
+}
+
+auto main(int argc, char **argv) -> int {
+    if (argc > 2) {
+        std::cerr << "usage: timeout_benchmark [num_requests]\n";
+        return -1;
+    }
+    std::size_t num_requests = argc > 1 ? std::stoul(argv[1]) : 100000;
+    for (auto mode : {"wheel", "link"}) {
+        runtime::CurrentThreadBuilder::default_create().block_on(main_loop(mode, num_requests));
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "zedio/core.hpp"
+#include "zedio/log.hpp"
+
+// C++
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace zedio::log;
+using namespace zedio;
+
+// Drives a worker's timer directly, expired sleeps are only counted
+struct CountingQueue {
+    void push_back_or_overflow(std::coroutine_handle<>, CountingQueue &) {
+        count_ += 1;
+    }
+
+    std::size_t count_{0};
+};
+
+template <typename F>
+auto measure(const char *name, std::size_t num_ops, F &&f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+    console.info("{:>7}: {} timers, elapsed: {:.3f}s, throughput: {:.0f} ops/s",
+                 name,
+                 num_ops,
+                 elapsed.count(),
+                 static_cast<double>(num_ops) / elapsed.count());
+}
+
+auto main(int argc, char **argv) -> int {
+    if (argc > 2) {
+        std::cerr << "usage: timer_benchmark [num_timers]\n";
+        return -1;
+    }
+    std::size_t num_timers = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+
+    runtime::detail::Timer                timer;
+    CountingQueue                         queue;
+    std::mt19937_64                       rng{42};
+    std::vector<runtime::detail::Entry *> entries(num_timers);
+
+    // Deadlines spread over a minute land on the first three levels of the wheel
+    auto now = std::chrono::steady_clock::now();
+    measure("insert", num_timers, [&]() {
+        for (auto &entry : entries) {
+            auto deadline = now + std::chrono::milliseconds{1'000 + rng() % 60'000};
+            entry = timer.add_entry(deadline, std::noop_coroutine()).value();
+        }
+    });
+
+    // Cancel in random order, like I/O completing before its timeout
+    std::shuffle(entries.begin(), entries.end(), rng);
+    measure("cancel", num_timers, [&]() {
+        for (auto entry : entries) {
+            timer.remove_entry(entry);
+        }
+    });
+
+    // Everything is due, polls expire it all and move entries down the levels
+    now = std::chrono::steady_clock::now();
+    for (auto i = 0uz; i < num_timers; ++i) {
+        auto deadline = now + std::chrono::milliseconds{1'000 + rng() % 1'000};
+        (void)timer.add_entry(deadline, std::noop_coroutine());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds{2'200});
+    measure("expire", num_timers, [&]() {
+        while (queue.count_ < num_timers) {
+            timer.update_now();
+            (void)timer.handle_expired_entries(queue, queue);
+        }
+    });
+
+    if (queue.count_ != num_timers) {
+        console.error("expired {} timers, expected {}", queue.count_, num_timers);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "zedio/core.hpp"
+#include "zedio/log.hpp"
+#include "zedio/time.hpp"
+
+// C++
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace zedio::async;
+using namespace zedio::log;
+using namespace zedio;
+
+// How late sleeps wake up at each timer resolution, with the cached clock a
+// sleep counts from the last poll and may wake up early
+auto measure(std::chrono::nanoseconds duration, std::size_t num_sleeps) -> Task<void> {
+    std::vector<std::chrono::nanoseconds> lateness;
+    lateness.reserve(num_sleeps);
+    for (auto i = 0uz; i < num_sleeps; ++i) {
+        auto deadline = std::chrono::steady_clock::now() + duration;
+        if (auto ret = co_await time::sleep(duration); !ret) {
+            console.error("sleep failed: {}", ret.error().message());
+            co_return;
+        }
+        lateness.push_back(std::chrono::steady_clock::now() - deadline);
+    }
+    std::sort(lateness.begin(), lateness.end());
+    auto us = [&](double percentile) {
+        auto idx = static_cast<std::size_t>(percentile * static_cast<double>(num_sleeps - 1));
+        return std::chrono::duration<double, std::micro>(lateness[idx]).count();
+    };
+    console.info("sleep: {:>6}us, late min: {:>8.1f}us, p50: {:>8.1f}us, p99: {:>8.1f}us, "
+                 "max: {:>8.1f}us",
+                 std::chrono::duration_cast<std::chrono::microseconds>(duration).count(),
+                 us(0.0),
+                 us(0.5),
+                 us(0.99),
+                 us(1.0));
+}
+
+auto main_loop(std::size_t num_sleeps) -> Task<void> {
+    for (auto duration : {std::chrono::nanoseconds{50us},
+                          std::chrono::nanoseconds{100us},
+                          std::chrono::nanoseconds{1ms}}) {
+        co_await measure(duration, num_sleeps);
+    }
+}
+
+auto main(int argc, char **argv) -> int {
+    if (argc > 2) {
+        std::cerr << "usage: timer_jitter_benchmark [num_sleeps]\n";
+        return -1;
+    }
+    std::size_t num_sleeps = argc > 1 ? std::stoul(argv[1]) : 500;
+    for (auto resolution : {std::chrono::nanoseconds{1ms},
+                            std::chrono::nanoseconds{100us},
+                            std::chrono::nanoseconds{10us}}) {
+        for (auto precise : {false, true}) {
+            console.info("resolution: {}us, clock: {}",
+                         std::chrono::duration_cast<std::chrono::microseconds>(resolution).count(),
+                         precise ? "precise" : "cached");
+            runtime::CurrentThreadBuilder::options()
+                .set_timer_resolution(resolution)
+                .set_precise_timer(precise)
+                .build()
+                .block_on(main_loop(num_sleeps));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "zedio/core.hpp"
+#include "zedio/fs/file.hpp"
+#include "zedio/log.hpp"
+
+// C++
+#include <string_view>
+
+using namespace zedio::async;
+using namespace zedio::fs;
+using namespace zedio;
+using namespace zedio::log;
+
+constexpr std::string_view PATH = "chain_test.txt";
+
+auto test() -> Task<void> {
+    auto file = co_await File::create(PATH);
+    if (!file) {
+        console.error("{}", file.error().message());
+        co_return;
+    }
+    auto             fd = file.value().fd();
+    std::string_view first = "hello ";
+    std::string_view second = "chain";
+    {
+        // Two writes and an fsync, submitted together and awaited once
+        auto [w1, w2, sync] = co_await io::chain(io::write(fd, first.data(), first.size(), 0),
+                                                 io::write(fd, second.data(), second.size(), 6),
+                                                 io::fsync(fd, 0));
+        console.info("write: {}, write: {}, fsync: {}",
+                     w1.value_or(0),
+                     w2.value_or(0),
+                     sync.has_value());
+    }
+    {
+        // A failed operation cancels the rest of a soft chain
+        auto [bad, canceled] = co_await io::chain(io::write(-1, first.data(), first.size(), 0),
+                                                  io::fsync(fd, 0));
+        console.info("bad fd: {}, then: {}",
+                     bad ? "ok" : bad.error().message(),
+                     canceled ? "ok" : canceled.error().message());
+    }
+    {
+        // A failure in the middle cancels what follows, the task resumes once
+        // every completion is in, whatever order they come in
+        auto [written, bad, canceled]
+            = co_await io::chain(io::write(fd, first.data(), first.size(), 0),
+                                 io::write(-1, second.data(), second.size(), 6),
+                                 io::fsync(fd, 0));
+        console.info("write: {}, bad fd: {}, then: {}",
+                     written.value_or(0),
+                     bad ? "ok" : bad.error().message(),
+                     canceled ? "ok" : canceled.error().message());
+    }
+    {
+        // But not the rest of a hard chain
+        auto [bad, synced] = co_await io::hard_chain(
+            io::write(-1, first.data(), first.size(), 0), io::fsync(fd, 0));
+        console.info("bad fd: {}, then: {}",
+                     bad ? "ok" : bad.error().message(),
+                     synced ? "ok" : synced.error().message());
+    }
+    co_await fs::remove_file(PATH);
+}
+
+auto main() -> int {
+    SET_LOG_LEVEL(LogLevel::Debug);
+    runtime::CurrentThreadBuilder::default_create().block_on(test());
+    return 0;
+}
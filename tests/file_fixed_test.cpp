@@ -0,0 +1,65 @@
+#include "zedio/core.hpp"
+#include "zedio/fs/file.hpp"
+#include "zedio/log.hpp"
+
+// C++
+#include <algorithm>
+#include <string_view>
+
+using namespace zedio::async;
+using namespace zedio::fs;
+using namespace zedio;
+using namespace zedio::log;
+
+constexpr std::string_view PATH = "file_fixed_test.txt";
+
+auto test() -> Task<void> {
+    auto file = co_await File::options()
+                    .read(true)
+                    .write(true)
+                    .create(true)
+                    .truncate(true)
+                    .permission(0666)
+                    .open(PATH);
+    if (!file) {
+        console.error("{}", file.error().message());
+        co_return;
+    }
+    auto out = io::FixedBuffer::lease();
+    auto in = io::FixedBuffer::lease();
+    if (!out || !in) {
+        console.error("lease failed");
+        co_return;
+    }
+    std::fill(out.value().capacity().begin(), out.value().capacity().end(), 'f');
+    out.value().set_size(out.value().capacity().size());
+    if (auto ret = co_await file.value().write_fixed(out.value(), 0); !ret) {
+        console.error("write_fixed failed: {}", ret.error().message());
+        co_return;
+    }
+    if (auto ret = co_await file.value().read_fixed(in.value(), 0); !ret) {
+        console.error("read_fixed failed: {}", ret.error().message());
+        co_return;
+    }
+    console.info("wrote {} bytes, read {} bytes, equal: {}",
+                 out.value().size(),
+                 in.value().size(),
+                 std::ranges::equal(out.value().data(), in.value().data()));
+    // Every buffer is leased, the pool reports ENOBUFS
+    {
+        auto third = io::FixedBuffer::lease();
+        auto fourth = io::FixedBuffer::lease();
+        console.info("pool exhausted: {}", !fourth.has_value());
+    }
+    co_await fs::remove_file(PATH);
+}
+
+auto main() -> int {
+    SET_LOG_LEVEL(LogLevel::Debug);
+    runtime::MultiThreadBuilder::options()
+        .set_num_workers(2)
+        .set_registered_buffers(3, 4096)
+        .build()
+        .block_on(test());
+    return 0;
+}
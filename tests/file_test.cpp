@@ -28,7 +28,9 @@ auto test_file_create() -> Task<void> {
     } else {
         console.error("{} {}", meta.error().value(), meta.error().message());
     }
-    ret.value().seek(0, SEEK_SET);
+    if (auto seek_ret = ret.value().seek(0, SEEK_SET); !seek_ret) {
+        console.error("{} {}", seek_ret.error().value(), seek_ret.error().message());
+    }
     {
         std::string buf = "hahah\n";
         co_await ret.value().read_to_end(buf);
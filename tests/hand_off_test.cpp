@@ -0,0 +1,36 @@
+#define BOOST_TEST_MODULE hand_off_test
+
+#include "zedio/runtime/driver.hpp"
+#include "zedio/runtime/multi_thread/queue.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+using namespace zedio::runtime;
+
+BOOST_AUTO_TEST_SUITE(hand_off_test)
+
+// A post that cannot be delivered comes back with its task and its target
+BOOST_AUTO_TEST_CASE(failed_post_test) {
+    detail::Config            config;
+    detail::Driver            driver{config};
+    multi_thread::LocalQueue  local_queue;
+    multi_thread::GlobalQueue global_queue;
+    // Never resumed, only the address travels
+    alignas(16) static char frame[16];
+    auto task = std::coroutine_handle<>::from_address(frame);
+    BOOST_REQUIRE(detail::Driver::can_post_task(task));
+
+    // Not a ring, the kernel refuses the message
+    driver.post_task(-1, 3, task);
+    for (auto i = 0; i < 100 && local_queue.empty(); ++i) {
+        driver.poll(local_queue, global_queue);
+    }
+    BOOST_REQUIRE_EQUAL(local_queue.size(), 1uz);
+    BOOST_CHECK_EQUAL(local_queue.pop().value().address(), static_cast<void *>(frame));
+    auto failed = driver.take_failed_posts();
+    BOOST_REQUIRE_EQUAL(failed.size(), 1uz);
+    BOOST_CHECK_EQUAL(failed.front(), 3uz);
+    BOOST_CHECK(driver.take_failed_posts().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,173 @@
+#define BOOST_TEST_MODULE idle_test
+
+#include "zedio/runtime/multi_thread/idle.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <set>
+#include <thread>
+
+using namespace zedio::runtime::multi_thread;
+
+BOOST_AUTO_TEST_SUITE(idle_test)
+
+BOOST_AUTO_TEST_CASE(sleepers_test) {
+    constexpr std::size_t num_workers = 130;
+    Idle                  idle{num_workers};
+    BOOST_CHECK(!idle.worker_to_notify().has_value());
+    for (auto i = 0uz; i < num_workers; ++i) {
+        BOOST_CHECK(!idle.transition_worker_to_sleeping(i, false));
+        BOOST_CHECK(idle.contains(i));
+    }
+    // Woken workers must be all distinct, across every word of the bitmap
+    std::set<std::size_t> woken;
+    for (auto i = 0uz; i < num_workers; ++i) {
+        auto worker = idle.worker_to_notify();
+        BOOST_REQUIRE(worker.has_value());
+        BOOST_CHECK(!idle.contains(worker.value()));
+        woken.insert(worker.value());
+        // The notified worker is searching, nobody else should be woken
+        BOOST_CHECK(!idle.worker_to_notify().has_value());
+        BOOST_CHECK(idle.transition_worker_from_searching());
+    }
+    BOOST_CHECK_EQUAL(woken.size(), num_workers);
+    BOOST_CHECK(!idle.worker_to_notify().has_value());
+}
+
+BOOST_AUTO_TEST_CASE(remove_test) {
+    Idle idle{70};
+    BOOST_CHECK(!idle.remove(69));
+    BOOST_CHECK(!idle.transition_worker_to_sleeping(69, false));
+    BOOST_CHECK(idle.remove(69));
+    BOOST_CHECK(!idle.contains(69));
+    BOOST_CHECK(!idle.worker_to_notify().has_value());
+
+    BOOST_CHECK(!idle.transition_worker_to_sleeping(3, false));
+    auto worker = idle.worker_to_notify();
+    BOOST_REQUIRE(worker.has_value());
+    BOOST_CHECK_EQUAL(worker.value(), 3);
+    // Already claimed by the notifier
+    BOOST_CHECK(!idle.remove(3));
+    BOOST_CHECK(idle.transition_worker_from_searching());
+}
+
+BOOST_AUTO_TEST_CASE(claim_sleeper_test) {
+    Idle idle{130};
+    BOOST_CHECK(!idle.claim_sleeper(0).has_value());
+    // The hint picks the word to start from and the bit to rotate from
+    auto claim = [&](std::size_t worker, std::size_t hint) {
+        BOOST_REQUIRE(!idle.transition_worker_to_sleeping(worker, false));
+        BOOST_CHECK(!idle.transition_worker_to_sleeping(worker == 5 ? 100 : 5, false));
+        BOOST_CHECK_EQUAL(idle.claim_sleeper(hint).value(), worker);
+        BOOST_CHECK(!idle.contains(worker));
+        // Claimed workers wake up searching, the other one is left asleep
+        BOOST_CHECK(!idle.remove(worker));
+        BOOST_CHECK(idle.transition_worker_from_searching());
+        BOOST_CHECK(idle.remove(worker == 5 ? 100 : 5));
+    };
+    claim(5, 0);
+    claim(5, 6);
+    claim(100, 64);
+    claim(100, 101);
+    claim(5, 129);
+    // Nobody left to claim or notify, and nothing was leaked
+    BOOST_CHECK(!idle.claim_sleeper(0).has_value());
+    BOOST_CHECK(!idle.worker_to_notify().has_value());
+    BOOST_CHECK(!idle.transition_worker_to_sleeping(7, false));
+    BOOST_CHECK_EQUAL(idle.worker_to_notify().value(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_test) {
+    constexpr std::size_t          num_workers = 96;
+    constexpr std::size_t          num_rounds = 2000;
+    Idle                           idle{num_workers};
+    std::atomic<bool>              stop{false};
+    std::atomic<int>               duplicated{0};
+    std::vector<std::atomic<bool>> awake(num_workers);
+    for (auto &flag : awake) {
+        flag = true;
+    }
+    std::vector<std::thread> threads;
+    for (auto t = 0uz; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            for (auto r = 0uz; r < num_rounds; ++r) {
+                auto worker = t * 24 + r % 24;
+                if (!awake[worker].exchange(false)) {
+                    continue;
+                }
+                (void)idle.transition_worker_to_sleeping(worker, false);
+                if (r % 3 == 0 && idle.remove(worker)) {
+                    awake[worker] = true;
+                }
+            }
+        });
+    }
+    threads.emplace_back([&]() {
+        while (!stop.load()) {
+            if (auto worker = idle.worker_to_notify(); worker) {
+                if (awake[worker.value()].exchange(true)) {
+                    duplicated.fetch_add(1);
+                }
+                (void)idle.transition_worker_from_searching();
+            }
+        }
+    });
+    for (auto i = 0uz; i < 4; ++i) {
+        threads[i].join();
+    }
+    stop = true;
+    threads.back().join();
+    BOOST_CHECK_EQUAL(duplicated.load(), 0);
+    // Wake up the rest, every sleeper must be reachable
+    while (auto worker = idle.worker_to_notify()) {
+        BOOST_CHECK(!awake[worker.value()].exchange(true));
+        (void)idle.transition_worker_from_searching();
+    }
+    for (auto i = 0uz; i < num_workers; ++i) {
+        BOOST_CHECK(awake[i].load());
+        BOOST_CHECK(!idle.contains(i));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(remove_race_test) {
+    constexpr std::size_t      num_rounds = 20'000;
+    Idle                       idle{1};
+    std::atomic<std::size_t>   round{0};
+    std::atomic<std::size_t>   done{0};
+    bool                       removed{false};
+    std::optional<std::size_t> notified;
+    // The sleeper wakes up by itself while a notifier is picking it
+    auto run = [&](auto &&f) {
+        return std::thread([&, f]() {
+            for (auto r = 1uz; r <= num_rounds; ++r) {
+                while (round.load() != r) {
+                    std::this_thread::yield();
+                }
+                f();
+                done.fetch_add(1);
+            }
+        });
+    };
+    auto sleeper = run([&]() { removed = idle.remove(0); });
+    auto notifier = run([&]() { notified = idle.worker_to_notify(); });
+    for (auto r = 1uz; r <= num_rounds; ++r) {
+        BOOST_REQUIRE(!idle.transition_worker_to_sleeping(0, false));
+        round = r;
+        while (done.load() != 2 * r) {
+            std::this_thread::yield();
+        }
+        // Exactly one of them claims the worker
+        BOOST_REQUIRE_NE(removed, notified.has_value());
+        if (notified) {
+            BOOST_REQUIRE(idle.transition_worker_from_searching());
+        }
+        BOOST_REQUIRE(!idle.contains(0));
+    }
+    sleeper.join();
+    notifier.join();
+    // Nothing was leaked, the worker can still be notified
+    BOOST_REQUIRE(!idle.transition_worker_to_sleeping(0, false));
+    BOOST_CHECK_EQUAL(idle.worker_to_notify().value(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,52 @@
+#include "zedio/core.hpp"
+#include "zedio/log.hpp"
+#include "zedio/time.hpp"
+
+// Linux
+#include <unistd.h>
+
+using namespace zedio::async;
+using namespace zedio::log;
+using namespace zedio;
+using namespace std::chrono_literals;
+
+auto test() -> Task<void> {
+    int fds[2];
+    if (::pipe(fds) != 0) {
+        console.error("pipe failed");
+        co_return;
+    }
+    char buf[16];
+    // Nobody writes, both reads run into their deadline
+    auto start = std::chrono::steady_clock::now();
+    auto ret = co_await io::read(fds[0], buf, sizeof(buf), static_cast<uint64_t>(-1))
+                   .set_link_timeout(100ms);
+    console.info("link timeout: {} after {}",
+                 ret ? "no error" : ret.error().message(),
+                 std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now() - start));
+
+    start = std::chrono::steady_clock::now();
+    ret = co_await io::read(fds[0], buf, sizeof(buf), static_cast<uint64_t>(-1))
+              .set_timeout(100ms);
+    console.info("wheel timeout: {} after {}",
+                 ret ? "no error" : ret.error().message(),
+                 std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now() - start));
+
+    // Data arrives in time, the linked timeout is cancelled by the kernel
+    if (::write(fds[1], "x", 1) != 1) {
+        console.error("write failed");
+    }
+    ret = co_await io::read(fds[0], buf, sizeof(buf), static_cast<uint64_t>(-1))
+              .set_link_timeout(1s);
+    console.info("read before the deadline: {}", ret.value_or(0));
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+auto main() -> int {
+    SET_LOG_LEVEL(LogLevel::Debug);
+    runtime::CurrentThreadBuilder::default_create().block_on(test());
+    return 0;
+}
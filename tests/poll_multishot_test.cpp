@@ -0,0 +1,54 @@
+#include "zedio/core.hpp"
+#include "zedio/log.hpp"
+
+// Linux
+#include <unistd.h>
+
+using namespace zedio::async;
+using namespace zedio::log;
+using namespace zedio;
+
+constexpr std::size_t NUM_ROUNDS = 100;
+
+auto writer(int fd) -> Task<void> {
+    char byte = 'x';
+    for (auto i = 0uz; i < NUM_ROUNDS; ++i) {
+        if (auto ret = co_await io::write(fd, &byte, 1, static_cast<uint64_t>(-1)); !ret) {
+            console.error("write failed: {}", ret.error().message());
+            break;
+        }
+    }
+}
+
+auto test() -> Task<void> {
+    int fds[2];
+    if (::pipe(fds) != 0) {
+        console.error("pipe failed");
+        co_return;
+    }
+    spawn(writer(fds[1]));
+    // One poll request reports every time the pipe becomes readable
+    auto        poll = io::poll_multishot(fds[0], POLLIN);
+    std::size_t received{0};
+    while (received < NUM_ROUNDS) {
+        auto ret = co_await poll.next();
+        if (!ret) {
+            console.error("poll failed: {}", ret.error().message());
+            break;
+        }
+        char buf[NUM_ROUNDS];
+        if (auto ret = co_await io::read(fds[0], buf, sizeof(buf), static_cast<uint64_t>(-1));
+            ret) {
+            received += ret.value();
+        }
+    }
+    console.info("received {} bytes through multishot poll", received);
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+auto main() -> int {
+    SET_LOG_LEVEL(LogLevel::Debug);
+    runtime::CurrentThreadBuilder::default_create().block_on(test());
+    return 0;
+}
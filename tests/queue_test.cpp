@@ -4,6 +4,7 @@
 
 #include <boost/test/included/unit_test.hpp>
 
+#include <list>
 #include <thread>
 
 using namespace zedio::runtime::multi_thread;
@@ -18,8 +19,8 @@ BOOST_AUTO_TEST_CASE(local_queue_test) {
     BOOST_CHECK_EQUAL(lq.empty(), true);
     BOOST_CHECK_EQUAL(gq.size(), 0);
     BOOST_CHECK_EQUAL(gq.empty(), true);
-    auto           ele = std::noop_coroutine();
-    constexpr auto len = lq.capacity() + lq.capacity() / 2 + 1;
+    auto       ele = std::noop_coroutine();
+    const auto len = lq.capacity() + lq.capacity() / 2 + 1;
     for (auto i = 0uz; i < len; ++i) {
         lq.push_back_or_overflow(ele, gq);
     }
@@ -43,6 +44,29 @@ BOOST_AUTO_TEST_CASE(local_queue_test) {
     BOOST_CHECK_EQUAL(lq.capacity(), cnt);
 }
 
+BOOST_AUTO_TEST_CASE(local_queue_capacity_test) {
+    GlobalQueue gq;
+    LocalQueue  small{16};
+    LocalQueue  large{1024};
+    BOOST_CHECK_EQUAL(small.capacity(), 16);
+    BOOST_CHECK_EQUAL(large.capacity(), 1024);
+    auto ele = std::noop_coroutine();
+    for (auto i = 0uz; i < large.capacity(); ++i) {
+        large.push_back_or_overflow(ele, gq);
+    }
+    BOOST_CHECK_EQUAL(gq.size(), 0);
+    // Stealing from a larger queue is bounded by the capacity of the thief
+    auto task = large.steal_into(small);
+    BOOST_REQUIRE(task.has_value());
+    BOOST_CHECK_EQUAL(small.size(), small.capacity() / 2 - 1);
+    BOOST_CHECK_EQUAL(large.size(), large.capacity() - small.capacity() / 2);
+    for (auto i = small.size(); i < small.capacity() + 1; ++i) {
+        small.push_back_or_overflow(ele, gq);
+    }
+    BOOST_CHECK_EQUAL(small.size(), small.capacity() / 2);
+    BOOST_CHECK_EQUAL(gq.size(), small.capacity() / 2 + 1);
+}
+
 BOOST_AUTO_TEST_CASE(global_queue_test) {
     GlobalQueue gq;
     BOOST_CHECK_EQUAL(gq.size(), 0);
@@ -81,4 +105,71 @@ BOOST_AUTO_TEST_CASE(global_queue_test) {
     BOOST_REQUIRE_EQUAL(true, gq.empty());
 }
 
+BOOST_AUTO_TEST_CASE(global_queue_batch_test) {
+    GlobalQueue gq{64};
+    BOOST_CHECK_EQUAL(gq.capacity(), 64);
+    auto                               ele = std::noop_coroutine();
+    std::list<std::coroutine_handle<>> batch(48, ele);
+    std::atomic<std::size_t>           cnt{0};
+    std::vector<std::thread>           threads;
+    constexpr std::size_t              num = 16;
+    for (auto i = 0uz; i < 4; ++i) {
+        threads.emplace_back([&]() {
+            for (auto i = 0uz; i < num; ++i) {
+                gq.push_batch(batch, batch.size());
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    // Most of the tasks have spilled out of the ring
+    BOOST_REQUIRE_EQUAL(num * batch.size() * threads.size(), gq.size());
+    threads.clear();
+    for (auto i = 0uz; i < 4; ++i) {
+        threads.emplace_back([&]() {
+            std::size_t num = 0;
+            while (true) {
+                std::array<std::coroutine_handle<>, 7> tasks;
+                auto                                   n = gq.pop_n(tasks);
+                if (n == 0) {
+                    break;
+                }
+                num += n;
+            }
+            cnt += num;
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    BOOST_REQUIRE_EQUAL(num * batch.size() * threads.size(), cnt);
+    BOOST_REQUIRE_EQUAL(true, gq.empty());
+}
+
+BOOST_AUTO_TEST_CASE(global_queue_spill_order_test) {
+    GlobalQueue gq{8};
+    auto        task = [](std::size_t i) {
+        return std::coroutine_handle<>::from_address(reinterpret_cast<void *>(i * 16));
+    };
+    // 1..8 fill the ring, 9..12 spill
+    for (auto i = 1uz; i <= 12; ++i) {
+        gq.push(task(i));
+    }
+    for (auto i = 1uz; i <= 3; ++i) {
+        BOOST_REQUIRE(gq.pop().value() == task(i));
+    }
+    // The ring has room again, but 13 must stay behind the spilled tasks
+    gq.push(task(13));
+    std::array<std::coroutine_handle<>, 4> tasks;
+    auto                                   next = 4uz;
+    while (auto n = gq.pop_n(tasks)) {
+        for (auto i = 0uz; i < n; ++i) {
+            BOOST_REQUIRE(tasks[i] == task(next++));
+        }
+    }
+    BOOST_CHECK_EQUAL(next, 14uz);
+    BOOST_CHECK(gq.empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "zedio/core.hpp"
+#include "zedio/log.hpp"
+#include "zedio/net.hpp"
+#include "zedio/sync.hpp"
+
+using namespace zedio::async;
+using namespace zedio::net;
+using namespace zedio::log;
+using namespace zedio::sync;
+using namespace zedio;
+
+constexpr std::size_t NUM_MESSAGES = 1000;
+
+auto client(const SocketAddr &addr, Latch &latch) -> Task<void> {
+    auto ret = co_await TcpStream::connect(addr);
+    if (!ret) {
+        console.error("{}", ret.error().message());
+        co_return;
+    }
+    auto             stream = std::move(ret.value());
+    std::string_view str = "recv_multishot_test ping";
+    for (auto i{0uz}; i < NUM_MESSAGES; i += 1) {
+        if (auto ret = co_await stream.write_all(str); !ret) {
+            console.error("{}", ret.error().message());
+            break;
+        }
+    }
+    co_await stream.close();
+    co_await latch.arrive_and_wait();
+}
+
+auto server(const SocketAddr &addr, Latch &latch) -> Task<void> {
+    auto ret = TcpListener::bind(addr);
+    if (!ret) {
+        console.error("{}", ret.error().message());
+        co_return;
+    }
+    auto listener = std::move(ret.value());
+    spawn(client(addr, latch));
+    auto [stream, peer_addr] = (co_await listener.accept()).value();
+    auto        recv = stream.recv_multishot();
+    std::size_t total{0};
+    while (true) {
+        auto ret = co_await recv.next();
+        // Every buffer is queued, they are back by now
+        if (!ret && ret.error().value() == ENOBUFS) {
+            continue;
+        }
+        if (!ret) {
+            console.error("{}", ret.error().message());
+            break;
+        }
+        if (ret.value().empty()) {
+            break;
+        }
+        total += ret.value().size();
+    }
+    console.info("server received {} bytes, expected {}",
+                 total,
+                 NUM_MESSAGES * std::string_view{"recv_multishot_test ping"}.size());
+    co_await latch.arrive_and_wait();
+}
+
+auto test() -> Task<void> {
+    auto addr = SocketAddr::parse("localhost", 9997);
+    if (!addr) {
+        console.error("{}", addr.error().message());
+        co_return;
+    }
+    Latch latch{3};
+    spawn(server(addr.value(), latch));
+    co_await latch.arrive_and_wait();
+}
+
+auto main() -> int {
+    SET_LOG_LEVEL(zedio::log::LogLevel::Trace);
+    runtime::MultiThreadBuilder::options()
+        .set_provided_buffers(64, 256)
+        .build()
+        .block_on(test());
+    return 0;
+}
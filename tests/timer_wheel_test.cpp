@@ -0,0 +1,151 @@
+#define BOOST_TEST_MODULE timer_wheel_test
+
+#include "zedio/io/base/callback.hpp"
+#include "zedio/runtime/io/io_uring.hpp"
+#include "zedio/runtime/timer/wheel.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace zedio::runtime::detail;
+
+namespace {
+
+struct Harness {
+    auto add(uint64_t deadline) -> Entry * {
+        auto entry = pool_.make(deadline, std::coroutine_handle<>{});
+        wheel_.insert(entry);
+        deadlines_[entry] = deadline;
+        return entry;
+    }
+
+    void cancel(Entry *entry) {
+        wheel_.remove(entry);
+        pool_.destroy(entry);
+        deadlines_.erase(entry);
+    }
+
+    // Poll until nothing is due at `now`, returns the number of polls needed
+    auto advance(uint64_t now) -> std::size_t {
+        std::size_t polls{0};
+        do {
+            wheel_.poll(now, [&](Entry *entry) {
+                BOOST_REQUIRE(deadlines_.contains(entry));
+                BOOST_CHECK_LE(deadlines_[entry], now);
+                fired_.push_back(deadlines_[entry]);
+                deadlines_.erase(entry);
+                pool_.destroy(entry);
+            });
+            polls += 1;
+        } while (wheel_.next_deadline().value_or(now + 1) <= now);
+        return polls;
+    }
+
+    EntryPool                   pool_;
+    Wheel                       wheel_;
+    std::map<Entry *, uint64_t> deadlines_;
+    std::vector<uint64_t>       fired_;
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(timer_wheel_test)
+
+BOOST_AUTO_TEST_CASE(long_horizon_test) {
+    Harness h;
+    // A day, a month and a year ahead, all on the upper levels
+    std::vector<uint64_t> deadlines{86'400'007ull, 2'592'000'013ull, 31'536'000'029ull};
+    for (auto deadline : deadlines) {
+        h.add(deadline);
+    }
+    for (auto deadline : deadlines) {
+        // Cascading must not fire anything a tick early
+        h.advance(deadline - 1);
+        BOOST_CHECK(h.fired_.empty());
+        h.advance(deadline);
+        BOOST_REQUIRE_EQUAL(h.fired_.size(), 1uz);
+        BOOST_CHECK_EQUAL(h.fired_.front(), deadline);
+        h.fired_.clear();
+    }
+    BOOST_CHECK(!h.wheel_.next_deadline().has_value());
+}
+
+BOOST_AUTO_TEST_CASE(top_level_wrap_test) {
+    Harness h;
+    h.advance(5);
+    // The furthest deadline accepted shares the current top level slot, the
+    // other top level slots expire before it
+    std::vector<uint64_t> deadlines{5 + Wheel::MAX_TICKS / 2, 5 + Wheel::MAX_TICKS - 1};
+    h.add(deadlines[1]);
+    BOOST_CHECK_EQUAL(h.wheel_.next_deadline().value(), Wheel::MAX_TICKS);
+    h.add(deadlines[0]);
+    BOOST_CHECK_EQUAL(h.wheel_.next_deadline().value(), Wheel::MAX_TICKS / 2);
+    h.advance(6);
+    BOOST_CHECK_EQUAL(h.wheel_.elapsed(), 6u);
+    for (auto deadline : deadlines) {
+        h.advance(deadline - 1);
+        BOOST_CHECK(h.fired_.empty());
+        h.advance(deadline);
+        BOOST_REQUIRE_EQUAL(h.fired_.size(), 1uz);
+        BOOST_CHECK_EQUAL(h.fired_.front(), deadline);
+        h.fired_.clear();
+    }
+    BOOST_CHECK(!h.wheel_.next_deadline().has_value());
+}
+
+BOOST_AUTO_TEST_CASE(random_test) {
+    Harness         h;
+    std::mt19937_64 rng{7};
+    uint64_t        now{0};
+    for (auto round = 0; round < 100'000; ++round) {
+        switch (rng() % 4) {
+        case 0:
+        case 1:
+            h.add(now + 1 + rng() % (1ull << (rng() % 32)));
+            break;
+        case 2:
+            if (!h.deadlines_.empty()) {
+                h.cancel(h.deadlines_.begin()->first);
+            }
+            break;
+        default:
+            now += rng() % 64;
+            h.advance(now);
+            if (round % 1'000 == 0) {
+                for (auto [_, deadline] : h.deadlines_) {
+                    BOOST_REQUIRE_GT(deadline, now);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cascade_budget_test) {
+    Harness h;
+    // Far enough to share one slot of level 2
+    constexpr uint64_t   base{64 * 64 * 3};
+    auto                 num_entries = TIMER_CASCADE_BUDGET * 2 + 10;
+    std::vector<Entry *> entries;
+    for (auto i = 0uz; i < num_entries; ++i) {
+        entries.push_back(h.add(base + 100 + i % 1000));
+    }
+    // The slot comes due, a poll only cascades part of it
+    h.wheel_.poll(base, [](Entry *) { BOOST_FAIL("nothing is due yet"); });
+    BOOST_CHECK_EQUAL(h.wheel_.next_deadline().value(), base);
+    // Entries still waiting to be cascaded can be cancelled
+    for (auto i = 0uz; i < num_entries; i += 2) {
+        h.cancel(entries[i]);
+    }
+    BOOST_CHECK_EQUAL(h.advance(base), 1uz);
+    BOOST_CHECK(h.fired_.empty());
+    // The first level 1 slot left
+    BOOST_CHECK_EQUAL(h.wheel_.next_deadline().value(), base + 64);
+    h.advance(base + 2'000);
+    BOOST_CHECK_EQUAL(h.fired_.size(), num_entries / 2);
+    BOOST_CHECK(!h.wheel_.next_deadline().has_value());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
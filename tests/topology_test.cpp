@@ -0,0 +1,30 @@
+#define BOOST_TEST_MODULE topology_test
+
+#include "zedio/common/util/topology.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+using namespace zedio::util;
+
+BOOST_AUTO_TEST_SUITE(topology_test)
+
+BOOST_AUTO_TEST_CASE(parse_cpu_list_test) {
+    BOOST_CHECK(parse_cpu_list("").empty());
+    BOOST_CHECK((parse_cpu_list("3") == std::vector<int>{3}));
+    BOOST_CHECK((parse_cpu_list("0-3") == std::vector<int>{0, 1, 2, 3}));
+    BOOST_CHECK((parse_cpu_list("0-1,8,10-11\n") == std::vector<int>{0, 1, 8, 10, 11}));
+}
+
+BOOST_AUTO_TEST_CASE(cpu_topology_test) {
+    auto cpus = cpu_topology();
+    BOOST_REQUIRE(!cpus.empty());
+    for (auto i = 1uz; i < cpus.size(); ++i) {
+        BOOST_CHECK(std::tie(cpus[i - 1].node_, cpus[i - 1].llc_, cpus[i - 1].cpu_)
+                    < std::tie(cpus[i].node_, cpus[i].llc_, cpus[i].cpu_));
+    }
+    for (const auto &cpu : cpus) {
+        BOOST_CHECK_LE(cpu.llc_, cpu.cpu_);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
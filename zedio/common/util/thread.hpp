@@ -5,6 +5,7 @@
 #include <pthread.h>
 #include <unistd.h>
 // C++
+#include <span>
 #include <thread>
 
 namespace zedio::util {
@@ -25,4 +26,33 @@ static inline auto get_current_thread_name() -> std::string_view {
     return t_name;
 }
 
+// Bind the calling thread to `cpu`
+[[nodiscard]]
+static inline auto set_current_thread_affinity(int cpu) -> bool {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+// Restrict the calling thread to `cpus`
+[[nodiscard]]
+static inline auto set_current_thread_affinity(std::span<const int> cpus) -> bool {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+// Hint the cpu that the caller is busy waiting
+static inline void spin_loop_hint() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
 } // namespace zedio::util
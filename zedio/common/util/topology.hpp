@@ -0,0 +1,143 @@
+#pragma once
+
+// C++
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+// Linux
+#include <sched.h>
+
+namespace zedio::util {
+
+struct CpuInfo {
+    int cpu_;
+    // NUMA node, 0 if the kernel does not expose one
+    int node_;
+    // Lowest cpu sharing the last level cache with this cpu
+    int llc_;
+};
+
+// Parse a kernel cpu list such as "0-3,8,10-11"
+[[nodiscard]]
+static inline auto parse_cpu_list(std::string_view list) -> std::vector<int> {
+    std::vector<int> result;
+    while (!list.empty()) {
+        auto comma = list.find(',');
+        auto range = list.substr(0, comma);
+        list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+
+        int  first{0};
+        int  last{0};
+        auto [ptr, ec] = std::from_chars(range.data(), range.data() + range.size(), first);
+        if (ec != std::errc{}) {
+            continue;
+        }
+        last = first;
+        if (ptr != range.data() + range.size() && *ptr == '-') {
+            std::from_chars(ptr + 1, range.data() + range.size(), last);
+        }
+        for (auto cpu = first; cpu <= last; ++cpu) {
+            result.push_back(cpu);
+        }
+    }
+    return result;
+}
+
+namespace detail {
+
+    [[nodiscard]]
+    static inline auto read_line(const std::filesystem::path &path) -> std::optional<std::string> {
+        std::ifstream file{path};
+        std::string   line;
+        if (!file || !std::getline(file, line)) {
+            return std::nullopt;
+        }
+        return line;
+    }
+
+    [[nodiscard]]
+    static inline auto cpu_node(const std::filesystem::path &cpu_dir) -> int {
+        std::error_code ec;
+        for (const auto &entry : std::filesystem::directory_iterator{cpu_dir, ec}) {
+            auto name = entry.path().filename().string();
+            if (name.starts_with("node")) {
+                int node{0};
+                std::from_chars(name.data() + 4, name.data() + name.size(), node);
+                return node;
+            }
+        }
+        return 0;
+    }
+
+    [[nodiscard]]
+    static inline auto cpu_llc(const std::filesystem::path &cpu_dir, int cpu) -> int {
+        int             best_level{-1};
+        int             result{cpu};
+        std::error_code ec;
+        for (const auto &entry : std::filesystem::directory_iterator{cpu_dir / "cache", ec}) {
+            if (!entry.path().filename().string().starts_with("index")) {
+                continue;
+            }
+            auto level = read_line(entry.path() / "level");
+            auto shared = read_line(entry.path() / "shared_cpu_list");
+            if (!level || !shared) {
+                continue;
+            }
+            int  l{-1};
+            auto cpus = parse_cpu_list(shared.value());
+            std::from_chars(level->data(), level->data() + level->size(), l);
+            if (l > best_level && !cpus.empty()) {
+                best_level = l;
+                result = *std::min_element(cpus.begin(), cpus.end());
+            }
+        }
+        return result;
+    }
+
+} // namespace detail
+
+// Topology of the cpus the calling thread is allowed to run on, ordered by
+// node, then last level cache, then cpu
+[[nodiscard]]
+static inline auto cpu_topology() -> std::vector<CpuInfo> {
+    static const std::filesystem::path root{"/sys/devices/system/cpu"};
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    auto has_set = ::sched_getaffinity(0, sizeof(set), &set) == 0;
+
+    std::vector<int> cpus;
+    if (auto online = detail::read_line(root / "online"); online) {
+        cpus = parse_cpu_list(online.value());
+    } else {
+        for (auto cpu = 0u; cpu < std::thread::hardware_concurrency(); ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+
+    std::vector<CpuInfo> result;
+    for (auto cpu : cpus) {
+        if (has_set && (cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &set))) {
+            continue;
+        }
+        auto cpu_dir = root / ("cpu" + std::to_string(cpu));
+        result.push_back(CpuInfo{
+            .cpu_ = cpu,
+            .node_ = detail::cpu_node(cpu_dir),
+            .llc_ = detail::cpu_llc(cpu_dir, cpu),
+        });
+    }
+    std::sort(result.begin(), result.end(), [](const CpuInfo &a, const CpuInfo &b) {
+        return std::tie(a.node_, a.llc_, a.cpu_) < std::tie(b.node_, b.llc_, b.cpu_);
+    });
+    return result;
+}
+
+} // namespace zedio::util
@@ -41,6 +41,13 @@ public:
         flags_ |= flags;
     }
 
+    // Open into the fixed file table of the current ring.
+    // Requires `CurrentThreadBuilder::set_fixed_files`.
+    auto direct(bool on) noexcept -> Builder & {
+        direct_ = on;
+        return *this;
+    }
+
     [[REMEMBER_CO_AWAIT]]
     auto open(std::string_view path) {
         adjust_flags();
@@ -50,18 +57,33 @@ public:
             using Super = io::detail::IORegistrator<Open>;
 
         public:
-            Open(std::string_view path, int flags, mode_t mode)
-                : Super{io_uring_prep_openat, AT_FDCWD, path.data(), flags, mode} {}
+            Open(std::string_view path, int flags, mode_t mode, bool direct)
+                : Super{prep_open, path.data(), flags, mode, direct}
+                , direct_{direct} {}
 
             auto await_resume() const noexcept -> Result<F> {
                 if (this->cb_.result_ >= 0) [[likely]] {
-                    return F{this->cb_.result_};
+                    return F{direct_ ? io::make_fixed_file(this->cb_.result_) : this->cb_.result_};
                 } else {
                     return std::unexpected{make_sys_error(-this->cb_.result_)};
                 }
             }
+
+        private:
+            static void
+            prep_open(io_uring_sqe *sqe, const char *path, int flags, mode_t mode, bool direct) {
+                if (direct) {
+                    io_uring_prep_openat_direct(
+                        sqe, AT_FDCWD, path, flags, mode, IORING_FILE_INDEX_ALLOC);
+                } else {
+                    io_uring_prep_openat(sqe, AT_FDCWD, path, flags, mode);
+                }
+            }
+
+        private:
+            bool direct_;
         };
-        return Open(path, flags_, permission_);
+        return Open(path, flags_, permission_, direct_);
     }
 
 private:
@@ -94,6 +116,7 @@ private:
     bool append_{false};
     bool create_{false};
     bool truncate_{false};
+    bool direct_{false};
 
     int    flags_{0};
     mode_t permission_{0};
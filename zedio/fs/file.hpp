@@ -4,6 +4,7 @@
 #include "zedio/fs/builder.hpp"
 #include "zedio/fs/impl/impl_async_fsync.hpp"
 #include "zedio/fs/impl/impl_async_metadata.hpp"
+#include "zedio/io/base/fixed_buffer.hpp"
 #include "zedio/io/impl/impl_async_read.hpp"
 #include "zedio/io/impl/impl_async_write.hpp"
 #include "zedio/io/io.hpp"
@@ -35,7 +36,12 @@ public:
             if (!ret) {
                 co_return std::unexpected{ret.error()};
             }
-            buf.resize(old_len + ret.value().stx_size - lseek64(fd_, 0, SEEK_CUR));
+            // A fixed file has no fd to ask for its position
+            off64_t pos{0};
+            if (!io::is_fixed_file(fd_)) {
+                pos = ::lseek64(fd_, 0, SEEK_CUR);
+            }
+            buf.resize(old_len + ret.value().stx_size - pos);
         }
         auto span = std::span<char>{buf}.subspan(old_len);
         auto ret = Result<std::size_t>{};
@@ -55,9 +61,37 @@ public:
         co_return Result<void>{};
     }
 
+    /// Returns the new offset from the start of the file. Fixed files keep
+    /// their position in the ring and can not seek.
     [[nodiscard]]
-    auto seek(off64_t offset, int whence) noexcept {
-        ::lseek64(fd_, offset, whence);
+    auto seek(off64_t offset, int whence) noexcept -> Result<off64_t> {
+        if (io::is_fixed_file(fd_)) [[unlikely]] {
+            return std::unexpected{make_sys_error(EBADF)};
+        }
+        auto ret = ::lseek64(fd_, offset, whence);
+        if (ret == -1) [[unlikely]] {
+            return std::unexpected{make_sys_error(errno)};
+        }
+        return ret;
+    }
+
+    /// Read into the whole of `buf` at `offset`, -1 for the current position.
+    /// The size of `buf` becomes the number of bytes read.
+    [[REMEMBER_CO_AWAIT]]
+    auto read_fixed(io::FixedBuffer &buf,
+                    uint64_t         offset = static_cast<uint64_t>(-1)) const noexcept {
+        return ReadFixed{fd_, buf, offset};
+    }
+
+    /// Write the filled part of `buf` at `offset`, -1 for the current position
+    [[REMEMBER_CO_AWAIT]]
+    auto write_fixed(const io::FixedBuffer &buf,
+                     uint64_t offset = static_cast<uint64_t>(-1)) const noexcept {
+        return io::detail::WriteFixed{fd_,
+                                      buf.data().data(),
+                                      static_cast<unsigned>(buf.size()),
+                                      offset,
+                                      static_cast<int>(buf.index())};
     }
 
 public:
@@ -75,6 +109,34 @@ public:
     static auto options() -> detail::Builder<File> {
         return detail::Builder<File>{};
     }
+
+private:
+    class ReadFixed : public io::detail::IORegistrator<ReadFixed> {
+    private:
+        using Super = io::detail::IORegistrator<ReadFixed>;
+
+    public:
+        ReadFixed(int fd, io::FixedBuffer &buf, uint64_t offset)
+            : Super{io_uring_prep_read_fixed,
+                    fd,
+                    buf.capacity().data(),
+                    static_cast<unsigned>(buf.capacity().size()),
+                    offset,
+                    static_cast<int>(buf.index())}
+            , buf_{&buf} {}
+
+        auto await_resume() const noexcept -> Result<std::size_t> {
+            if (this->cb_.result_ >= 0) [[likely]] {
+                buf_->set_size(static_cast<std::size_t>(this->cb_.result_));
+                return static_cast<std::size_t>(this->cb_.result_);
+            } else {
+                return ::std::unexpected{make_sys_error(-this->cb_.result_)};
+            }
+        }
+
+    private:
+        io::FixedBuffer *buf_;
+    };
 };
 
 template <typename T>
@@ -23,6 +23,28 @@ namespace detail {
         }
     };
 
+    class AcceptDirect : public detail::IORegistrator<AcceptDirect> {
+    private:
+        using Super = detail::IORegistrator<AcceptDirect>;
+
+    public:
+        AcceptDirect(int fd, struct sockaddr *addr, socklen_t *addrlen, int flags)
+            : Super{io_uring_prep_accept_direct,
+                    fd,
+                    addr,
+                    addrlen,
+                    flags,
+                    IORING_FILE_INDEX_ALLOC} {}
+
+        auto await_resume() const noexcept -> Result<int> {
+            if (this->cb_.result_ >= 0) [[likely]] {
+                return make_fixed_file(this->cb_.result_);
+            } else {
+                return ::std::unexpected{make_sys_error(-this->cb_.result_)};
+            }
+        }
+    };
+
 } // namespace detail
 
 [[REMEMBER_CO_AWAIT]]
@@ -30,4 +52,10 @@ static inline auto accept(int fd, struct sockaddr *addr, socklen_t *addrlen, int
     return detail::Accept{fd, addr, addrlen, flags};
 }
 
+/// Accept into a free slot of the fixed file table, the result is a fixed file
+[[REMEMBER_CO_AWAIT]]
+static inline auto accept_direct(int fd, struct sockaddr *addr, socklen_t *addrlen, int flags) {
+    return detail::AcceptDirect{fd, addr, addrlen, flags};
+}
+
 } // namespace zedio::io
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "zedio/common/error.hpp"
+#include "zedio/io/base/multishot.hpp"
+// C++
+#include <algorithm>
+// Linux
+#include <liburing.h>
+#include <unistd.h>
+
+namespace zedio::io {
+
+namespace detail {
+
+    class AcceptMultishotCallback : public MultishotCallback {
+    public:
+        AcceptMultishotCallback(int fd, std::size_t max_pending)
+            : fd_{fd} {
+            max_pending_ = std::max(max_pending, 1uz);
+        }
+
+        void prep(io_uring_sqe *sqe, [[maybe_unused]] runtime::detail::IORing &ring) override {
+            io_uring_prep_multishot_accept(sqe, fd_, nullptr, nullptr, SOCK_NONBLOCK);
+        }
+
+        void discard(const Completion &completion) override {
+            if (completion.result_ >= 0) {
+                ::close(completion.result_);
+            }
+        }
+
+        // Errors such as EMFILE do not end the stream, the next call rearms
+        auto take() -> Result<int> {
+            auto completion = completions_.front();
+            completions_.pop_front();
+            if (completion.result_ >= 0) [[likely]] {
+                return completion.result_;
+            } else {
+                return std::unexpected{make_sys_error(-completion.result_)};
+            }
+        }
+
+    private:
+        int fd_;
+    };
+
+} // namespace detail
+
+/// Accept connections continuously with one request. Accepted fds queue up
+/// until `next()` takes them, once `max_pending` are queued the request is
+/// cancelled and new connections wait in the listen backlog of the kernel.
+using AcceptMultishot = detail::MultishotStream<detail::AcceptMultishotCallback>;
+
+} // namespace zedio::io
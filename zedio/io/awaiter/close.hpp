@@ -12,7 +12,7 @@ namespace detail {
 
     public:
         Close(int fd)
-            : Super{io_uring_prep_close, fd} {}
+            : Super{prep_close, fd} {}
 
         auto await_resume() const noexcept -> Result<void> {
             if (this->cb_.result_ >= 0) [[likely]] {
@@ -21,6 +21,15 @@ namespace detail {
                 return ::std::unexpected{make_sys_error(-this->cb_.result_)};
             }
         }
+
+    private:
+        static void prep_close(io_uring_sqe *sqe, int fd) {
+            if (is_fixed_file(fd)) {
+                io_uring_prep_close_direct(sqe, static_cast<unsigned>(fixed_file_index(fd)));
+            } else {
+                io_uring_prep_close(sqe, fd);
+            }
+        }
     };
 
 } // namespace detail
@@ -26,6 +26,28 @@ namespace detail {
         }
     };
 
+    class OpenDirect : public IORegistrator<OpenDirect> {
+    private:
+        using Super = IORegistrator<OpenDirect>;
+
+    public:
+        OpenDirect(int dfd, const char *path, int flags, mode_t mode)
+            : Super{io_uring_prep_openat_direct,
+                    dfd,
+                    path,
+                    flags,
+                    mode,
+                    IORING_FILE_INDEX_ALLOC} {}
+
+        auto await_resume() const noexcept -> Result<int> {
+            if (this->cb_.result_ >= 0) [[likely]] {
+                return make_fixed_file(this->cb_.result_);
+            } else {
+                return ::std::unexpected{make_sys_error(-this->cb_.result_)};
+            }
+        }
+    };
+
     class Open2 : public IORegistrator<Open2> {
     private:
         using Super = IORegistrator<Open2>;
@@ -63,6 +85,12 @@ static inline auto openat(int dfd, const char *path, int flags, mode_t mode) {
     return detail::Open{dfd, path, flags, mode};
 }
 
+/// Open into a free slot of the fixed file table, the result is a fixed file
+[[REMEMBER_CO_AWAIT]]
+static inline auto openat_direct(int dfd, const char *path, int flags, mode_t mode) {
+    return detail::OpenDirect{dfd, path, flags, mode};
+}
+
 [[REMEMBER_CO_AWAIT]]
 static inline auto openat2(int dfd, const char *path, struct open_how *how) {
     return detail::Open2{dfd, path, how};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "zedio/common/error.hpp"
+#include "zedio/io/base/multishot.hpp"
+// Linux
+#include <liburing.h>
+#include <poll.h>
+
+namespace zedio::io {
+
+namespace detail {
+
+    class PollMultishotCallback : public MultishotCallback {
+    public:
+        PollMultishotCallback(int fd, unsigned poll_mask)
+            : fd_{fd}
+            , poll_mask_{poll_mask} {}
+
+        void prep(io_uring_sqe *sqe, [[maybe_unused]] runtime::detail::IORing &ring) override {
+            io_uring_prep_poll_multishot(sqe, fd_, poll_mask_);
+        }
+
+        // Events of one completion, the next call rearms after an error
+        auto take() -> Result<unsigned> {
+            auto completion = completions_.front();
+            completions_.pop_front();
+            if (completion.result_ >= 0) [[likely]] {
+                return static_cast<unsigned>(completion.result_);
+            } else {
+                return std::unexpected{make_sys_error(-completion.result_)};
+            }
+        }
+
+    private:
+        int      fd_;
+        unsigned poll_mask_;
+    };
+
+} // namespace detail
+
+/// Report readiness of `fd` for `poll_mask` (POLLIN, POLLOUT, ...) every time
+/// it changes, without resubmitting a poll request per event
+[[nodiscard]]
+static inline auto poll_multishot(int fd, unsigned poll_mask) {
+    return detail::MultishotStream<detail::PollMultishotCallback>{fd, poll_mask};
+}
+
+} // namespace zedio::io
@@ -23,6 +23,24 @@ namespace detail {
         }
     };
 
+    // `buf` must lie in the buffer registered at `buf_index`
+    class ReadFixed : public IORegistrator<ReadFixed> {
+    private:
+        using Super = IORegistrator<ReadFixed>;
+
+    public:
+        ReadFixed(int fd, void *buf, unsigned nbytes, uint64_t offset, int buf_index)
+            : Super{io_uring_prep_read_fixed, fd, buf, nbytes, offset, buf_index} {}
+
+        auto await_resume() const noexcept -> Result<std::size_t> {
+            if (this->cb_.result_ >= 0) [[likely]] {
+                return static_cast<std::size_t>(this->cb_.result_);
+            } else {
+                return ::std::unexpected{make_sys_error(-this->cb_.result_)};
+            }
+        }
+    };
+
 } // namespace detail
 
 [[REMEMBER_CO_AWAIT]]
@@ -30,4 +48,9 @@ static inline auto read(int fd, void *buf, std::size_t nbytes, uint64_t offset)
     return detail::Read{fd, buf, nbytes, offset};
 }
 
+[[REMEMBER_CO_AWAIT]]
+static inline auto read_fixed(int fd, void *buf, unsigned nbytes, uint64_t offset, int buf_index) {
+    return detail::ReadFixed{fd, buf, nbytes, offset, buf_index};
+}
+
 } // namespace zedio::io
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "zedio/common/error.hpp"
+#include "zedio/common/util/noncopyable.hpp"
+#include "zedio/io/base/multishot.hpp"
+#include "zedio/runtime/io/io_uring.hpp"
+// C++
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <utility>
+// Linux
+#include <liburing.h>
+
+namespace zedio::io {
+
+/// A buffer borrowed from the provided buffer ring of a worker. Goes back to
+/// the kernel when destroyed, so keep it no longer than the data is needed
+/// and never past the runtime.
+class ProvidedBuffer : util::Noncopyable {
+public:
+    ProvidedBuffer() = default;
+
+    ProvidedBuffer(runtime::detail::BufRing *buf_ring, uint16_t id, std::size_t len)
+        : buf_ring_{buf_ring}
+        , id_{id}
+        , len_{len} {}
+
+    ProvidedBuffer(ProvidedBuffer &&other) noexcept
+        : buf_ring_{std::exchange(other.buf_ring_, nullptr)}
+        , id_{other.id_}
+        , len_{std::exchange(other.len_, 0)} {}
+
+    auto operator=(ProvidedBuffer &&other) noexcept -> ProvidedBuffer & {
+        if (this != &other) {
+            reset();
+            buf_ring_ = std::exchange(other.buf_ring_, nullptr);
+            id_ = other.id_;
+            len_ = std::exchange(other.len_, 0);
+        }
+        return *this;
+    }
+
+    ~ProvidedBuffer() {
+        reset();
+    }
+
+public:
+    [[nodiscard]]
+    auto data() const noexcept -> std::span<char> {
+        if (buf_ring_ == nullptr) {
+            return {};
+        }
+        return buf_ring_->data(id_).first(len_);
+    }
+
+    [[nodiscard]]
+    auto size() const noexcept -> std::size_t {
+        return len_;
+    }
+
+    [[nodiscard]]
+    auto empty() const noexcept -> bool {
+        return len_ == 0;
+    }
+
+    // Give the buffer back to the kernel now
+    void reset() noexcept {
+        if (buf_ring_ != nullptr) {
+            buf_ring_->give_back(id_);
+            buf_ring_ = nullptr;
+            len_ = 0;
+        }
+    }
+
+private:
+    runtime::detail::BufRing *buf_ring_{nullptr};
+    uint16_t                  id_{0};
+    std::size_t               len_{0};
+};
+
+namespace detail {
+
+    class RecvMultishotCallback : public MultishotCallback {
+    public:
+        explicit RecvMultishotCallback(int sockfd)
+            : sockfd_{sockfd} {}
+
+        void prep(io_uring_sqe *sqe, runtime::detail::IORing &ring) override {
+            buf_ring_ = ring.buf_ring();
+            io_uring_prep_recv_multishot(sqe, sockfd_, nullptr, 0, 0);
+            sqe->flags |= IOSQE_BUFFER_SELECT;
+            sqe->buf_group = buf_ring_->group_id();
+        }
+
+        void discard(const Completion &completion) override {
+            to_buffer(completion).reset();
+        }
+
+        [[nodiscard]]
+        auto should_rearm() noexcept -> bool {
+            if (runtime::detail::t_ring->buf_ring() == nullptr) [[unlikely]] {
+                // Provided buffers are not enabled in the builder
+                result_ = -ENOBUFS;
+                return false;
+            }
+            return completions_.empty();
+        }
+
+        [[nodiscard]]
+        auto done() const noexcept -> bool {
+            return result_.has_value();
+        }
+
+        // An empty buffer means the peer closed the connection. ENOBUFS does
+        // not end the stream, the next call arms the request again.
+        auto take() -> Result<ProvidedBuffer> {
+            if (completions_.empty()) {
+                return finish(result_.value());
+            }
+            auto completion = completions_.front();
+            completions_.pop_front();
+            if (completion.result_ == -ENOBUFS) {
+                return std::unexpected{make_sys_error(ENOBUFS)};
+            }
+            if (completion.result_ <= 0) {
+                result_ = completion.result_;
+                return finish(completion.result_);
+            }
+            if ((completion.flags_ & IORING_CQE_F_BUFFER) == 0) [[unlikely]] {
+                // Data without a buffer, never an end of stream
+                return std::unexpected{make_sys_error(EIO)};
+            }
+            return to_buffer(completion);
+        }
+
+    private:
+        [[nodiscard]]
+        auto to_buffer(const Completion &completion) const noexcept -> ProvidedBuffer {
+            if ((completion.flags_ & IORING_CQE_F_BUFFER) == 0) {
+                return {};
+            }
+            return ProvidedBuffer{buf_ring_,
+                                  static_cast<uint16_t>(completion.flags_
+                                                        >> IORING_CQE_BUFFER_SHIFT),
+                                  static_cast<std::size_t>(std::max(completion.result_, 0))};
+        }
+
+        static auto finish(int result) -> Result<ProvidedBuffer> {
+            if (result == 0) {
+                return ProvidedBuffer{};
+            }
+            return std::unexpected{make_sys_error(-result)};
+        }
+
+    private:
+        int                       sockfd_;
+        runtime::detail::BufRing *buf_ring_{nullptr};
+        // Set once the stream reached its end or failed
+        std::optional<int>        result_{};
+    };
+
+} // namespace detail
+
+/// Receive into buffers picked by the kernel from the provided buffer ring of
+/// the worker. One request keeps receiving until the peer closes or an error
+/// occurs, an idle connection holds no buffer at all. When the ring runs dry
+/// `next()` reports ENOBUFS instead of rearming right away, release buffers
+/// or back off before calling it again.
+using RecvMultishot = detail::MultishotStream<detail::RecvMultishotCallback>;
+
+} // namespace zedio::io
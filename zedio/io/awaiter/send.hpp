@@ -23,6 +23,8 @@ namespace detail {
         }
     };
 
+    // Completes once the kernel no longer references `buf`, which is after the
+    // notification CQE that follows the result
     class SendZC : public IORegistrator<SendZC> {
     private:
         using Super = IORegistrator<SendZC>;
@@ -40,6 +42,29 @@ namespace detail {
         }
     };
 
+    // `buf` must lie in the buffer registered at `buf_index`
+    class SendZCFixed : public IORegistrator<SendZCFixed> {
+    private:
+        using Super = IORegistrator<SendZCFixed>;
+
+    public:
+        SendZCFixed(int         sockfd,
+                    const void *buf,
+                    size_t      len,
+                    int         flags,
+                    unsigned    zc_flags,
+                    unsigned    buf_index)
+            : Super{io_uring_prep_send_zc_fixed, sockfd, buf, len, flags, zc_flags, buf_index} {}
+
+        auto await_resume() const noexcept -> Result<std::size_t> {
+            if (this->cb_.result_ >= 0) [[likely]] {
+                return static_cast<std::size_t>(this->cb_.result_);
+            } else {
+                return ::std::unexpected{make_sys_error(-this->cb_.result_)};
+            }
+        }
+    };
+
 } // namespace detail
 
 [[REMEMBER_CO_AWAIT]]
@@ -52,4 +77,14 @@ static inline auto send_zc(int sockfd, const void *buf, size_t len, int flags, u
     return detail::SendZC{sockfd, buf, len, flags, zc_flags};
 }
 
+[[REMEMBER_CO_AWAIT]]
+static inline auto send_zc_fixed(int         sockfd,
+                                 const void *buf,
+                                 size_t      len,
+                                 int         flags,
+                                 unsigned    zc_flags,
+                                 unsigned    buf_index) {
+    return detail::SendZCFixed{sockfd, buf, len, flags, zc_flags, buf_index};
+}
+
 } // namespace zedio::io
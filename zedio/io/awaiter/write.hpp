@@ -23,6 +23,24 @@ namespace detail {
         }
     };
 
+    // `buf` must lie in the buffer registered at `buf_index`
+    class WriteFixed : public IORegistrator<WriteFixed> {
+    private:
+        using Super = IORegistrator<WriteFixed>;
+
+    public:
+        WriteFixed(int fd, const void *buf, unsigned nbytes, __u64 offset, int buf_index)
+            : Super{io_uring_prep_write_fixed, fd, buf, nbytes, offset, buf_index} {}
+
+        auto await_resume() const noexcept -> Result<std::size_t> {
+            if (this->cb_.result_ >= 0) [[likely]] {
+                return static_cast<std::size_t>(this->cb_.result_);
+            } else {
+                return ::std::unexpected{make_sys_error(-this->cb_.result_)};
+            }
+        }
+    };
+
 } // namespace detail
 
 [[REMEMBER_CO_AWAIT]]
@@ -30,4 +48,10 @@ static inline auto write(int fd, const void *buf, unsigned nbytes, __u64 offset)
     return detail::Write(fd, buf, nbytes, offset);
 }
 
+[[REMEMBER_CO_AWAIT]]
+static inline auto
+write_fixed(int fd, const void *buf, unsigned nbytes, __u64 offset, int buf_index) {
+    return detail::WriteFixed(fd, buf, nbytes, offset, buf_index);
+}
+
 } // namespace zedio::io
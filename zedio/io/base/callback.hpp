@@ -3,6 +3,7 @@
 // C++
 #include <chrono>
 #include <coroutine>
+#include <cstdint>
 
 namespace zedio::runtime::detail {
 
@@ -12,11 +13,26 @@ class Entry;
 
 namespace zedio::io::detail {
 
+// The low bits of user_data tell the driver what completed, callbacks and
+// coroutine frames are aligned to at least 8 bytes
+static inline constexpr uint64_t CALLBACK_TAG{0};
+// A task posted by another ring, or one that could not be posted coming back
+static inline constexpr uint64_t TASK_TAG{1};
+// A `MultishotCallback`
+static inline constexpr uint64_t MULTISHOT_TAG{2};
+// A `MultishotCallback` to cancel, forwarded by another thread
+static inline constexpr uint64_t CANCEL_TAG{3};
+static inline constexpr uint64_t TAG_MASK{3};
+
 struct Callback {
     std::coroutine_handle<>               handle_{nullptr};
     int                                   result_;
     runtime::detail::Entry               *entry_{nullptr};
     std::chrono::steady_clock::time_point deadline_;
+    // Completions its chain still waits for, null outside of a chain
+    std::size_t                          *num_pending_{nullptr};
 };
 
+static_assert(alignof(Callback) > TAG_MASK);
+
 } // namespace zedio::io::detail
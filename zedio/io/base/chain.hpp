@@ -0,0 +1,82 @@
+#pragma once
+
+#include "zedio/io/base/registrator.hpp"
+// C++
+#include <array>
+#include <concepts>
+#include <tuple>
+#include <utility>
+
+namespace zedio::io {
+
+namespace detail {
+
+    template <class IO>
+    concept Chainable = std::derived_from<IO, IORegistrator<IO>>;
+
+    /// Awaiters submitted as one IOSQE_IO_LINK or IOSQE_IO_HARDLINK chain. The
+    /// kernel starts each operation after the previous one and fails the rest
+    /// of a soft chain with ECANCELED, but does not promise to post their
+    /// completions in that order, and the notification of a zero copy send
+    /// may come last. The chain counts the completions still to come and the
+    /// task resumes on the last one, once no callback is written to anymore.
+    template <class... IOs>
+    class Chain {
+    public:
+        Chain(uint8_t flag, IOs &&...ios)
+            : ios_{std::move(ios)...} {
+            std::apply(
+                [flag](IOs &...ios) {
+                    std::array<io_uring_sqe *, sizeof...(IOs)> sqes{ios.sqe_...};
+                    runtime::detail::t_ring->link(sqes, flag);
+                    auto i = 0uz;
+                    ((ios.sqe_ = sqes[i++]), ...);
+                },
+                ios_);
+        }
+
+    public:
+        auto await_ready() const noexcept -> bool {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            num_pending_ = sizeof...(IOs);
+            std::apply(
+                [&](IOs &...ios) {
+                    ((ios.cb_.handle_ = handle, ios.cb_.num_pending_ = &num_pending_), ...);
+                },
+                ios_);
+            runtime::detail::t_ring->submit();
+        }
+
+        auto await_resume() {
+            return std::apply([](IOs &...ios) { return std::make_tuple(ios.await_resume()...); },
+                              ios_);
+        }
+
+    private:
+        std::tuple<IOs...> ios_;
+        std::size_t        num_pending_{0};
+    };
+
+} // namespace detail
+
+/// Submit `ios` as a chain that runs in order, e.g. a write and then an fsync,
+/// and resume once with all results. A failed operation cancels the rest.
+template <class... IOs>
+    requires(sizeof...(IOs) >= 2 && (detail::Chainable<IOs> && ...))
+[[REMEMBER_CO_AWAIT]]
+static inline auto chain(IOs &&...ios) {
+    return detail::Chain<IOs...>{IOSQE_IO_LINK, std::move(ios)...};
+}
+
+/// Like `chain`, but later operations run even if an earlier one fails
+template <class... IOs>
+    requires(sizeof...(IOs) >= 2 && (detail::Chainable<IOs> && ...))
+[[REMEMBER_CO_AWAIT]]
+static inline auto hard_chain(IOs &&...ios) {
+    return detail::Chain<IOs...>{IOSQE_IO_HARDLINK, std::move(ios)...};
+}
+
+} // namespace zedio::io
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "zedio/common/error.hpp"
+#include "zedio/common/util/noncopyable.hpp"
+#include "zedio/runtime/io/io_uring.hpp"
+// C++
+#include <span>
+#include <utility>
+
+namespace zedio::io {
+
+/// A buffer leased from the registered buffer pool of the runtime, see
+/// `set_registered_buffers` of the builder. Goes back to the pool when
+/// destroyed and must not outlive the runtime.
+class FixedBuffer : util::Noncopyable {
+private:
+    FixedBuffer(runtime::detail::BufferPool *pool, uint16_t index)
+        : pool_{pool}
+        , index_{index} {}
+
+public:
+    FixedBuffer(FixedBuffer &&other) noexcept
+        : pool_{std::exchange(other.pool_, nullptr)}
+        , index_{other.index_}
+        , len_{std::exchange(other.len_, 0)} {}
+
+    auto operator=(FixedBuffer &&other) noexcept -> FixedBuffer & {
+        if (this != &other) {
+            reset();
+            pool_ = std::exchange(other.pool_, nullptr);
+            index_ = other.index_;
+            len_ = std::exchange(other.len_, 0);
+        }
+        return *this;
+    }
+
+    ~FixedBuffer() {
+        reset();
+    }
+
+public:
+    // The filled part of the buffer
+    [[nodiscard]]
+    auto data() const noexcept -> std::span<char> {
+        return capacity().first(len_);
+    }
+
+    // The whole buffer
+    [[nodiscard]]
+    auto capacity() const noexcept -> std::span<char> {
+        if (pool_ == nullptr) {
+            return {};
+        }
+        return pool_->data(index_);
+    }
+
+    [[nodiscard]]
+    auto size() const noexcept -> std::size_t {
+        return len_;
+    }
+
+    void set_size(std::size_t len) noexcept {
+        len_ = std::min(len, capacity().size());
+    }
+
+    // Index of the buffer in the table registered with every ring
+    [[nodiscard]]
+    auto index() const noexcept -> unsigned {
+        return index_;
+    }
+
+    // Give the buffer back to the pool now
+    void reset() noexcept {
+        if (pool_ != nullptr) {
+            pool_->release(index_);
+            pool_ = nullptr;
+            len_ = 0;
+        }
+    }
+
+public:
+    // Fails with EINVAL outside a runtime with registered buffers, and with
+    // ENOBUFS while all buffers are leased
+    [[nodiscard]]
+    static auto lease() -> Result<FixedBuffer> {
+        auto pool = runtime::detail::t_ring != nullptr ? runtime::detail::t_ring->buffer_pool()
+                                                       : nullptr;
+        if (pool == nullptr) [[unlikely]] {
+            return std::unexpected{make_sys_error(EINVAL)};
+        }
+        auto index = pool->acquire();
+        if (!index) [[unlikely]] {
+            return std::unexpected{make_sys_error(ENOBUFS)};
+        }
+        return FixedBuffer{pool, index.value()};
+    }
+
+private:
+    runtime::detail::BufferPool *pool_{nullptr};
+    uint16_t                     index_{0};
+    std::size_t                  len_{0};
+};
+
+} // namespace zedio::io
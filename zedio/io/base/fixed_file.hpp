@@ -0,0 +1,39 @@
+#pragma once
+
+// Linux
+#include <liburing.h>
+
+namespace zedio::io {
+
+// A descriptor installed in the fixed file table of the current ring travels
+// as a plain int with this bit set, real fds never grow that large
+static inline constexpr int FIXED_FILE_TAG{1 << 30};
+
+[[nodiscard]]
+static inline constexpr auto is_fixed_file(int fd) noexcept -> bool {
+    return fd >= 0 && (fd & FIXED_FILE_TAG) != 0;
+}
+
+[[nodiscard]]
+static inline constexpr auto make_fixed_file(int index) noexcept -> int {
+    return index | FIXED_FILE_TAG;
+}
+
+[[nodiscard]]
+static inline constexpr auto fixed_file_index(int fd) noexcept -> int {
+    return fd & ~FIXED_FILE_TAG;
+}
+
+namespace detail {
+
+    // Turn a tagged fd in `sqe` into a fixed file index
+    static inline void apply_fixed_file(io_uring_sqe *sqe) noexcept {
+        if (is_fixed_file(sqe->fd)) {
+            sqe->fd = fixed_file_index(sqe->fd);
+            sqe->flags |= IOSQE_FIXED_FILE;
+        }
+    }
+
+} // namespace detail
+
+} // namespace zedio::io
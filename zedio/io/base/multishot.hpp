@@ -0,0 +1,220 @@
+#pragma once
+
+#include "zedio/common/debug.hpp"
+#include "zedio/common/macros.hpp"
+#include "zedio/common/util/noncopyable.hpp"
+#include "zedio/io/base/callback.hpp"
+#include "zedio/io/base/fixed_file.hpp"
+#include "zedio/runtime/io/io_uring.hpp"
+// C++
+#include <concepts>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <utility>
+// Linux
+#include <liburing.h>
+
+namespace zedio::io::detail {
+
+/// State of a request that completes many times. The driver queues every
+/// completion here and resumes the owner once per batch, the owner consumes
+/// them at its own pace. Lives on the heap, its address tagged with
+/// MULTISHOT_TAG is the user_data of the request. The owner may have been
+/// stolen by another worker, so both sides hold `mutex_` while touching the
+/// state.
+///
+/// Derived callbacks implement `prep` and `take`, the latter pops the front
+/// completion and converts it to the result of `MultishotStream::next()`.
+/// `prune`, `should_rearm` and `done` may be hidden to change how the stream
+/// goes on. All of them run with `mutex_` held.
+struct MultishotCallback {
+    struct Completion {
+        int      result_;
+        uint32_t flags_;
+    };
+
+    virtual ~MultishotCallback() = default;
+
+    // Fill `sqe` with the request
+    virtual void prep(io_uring_sqe *sqe, runtime::detail::IORing &ring) = 0;
+
+    // Release what a completion holds once nobody is left to consume it
+    virtual void discard([[maybe_unused]] const Completion &completion) {}
+
+    [[nodiscard]]
+    auto user_data() noexcept -> uint64_t {
+        return reinterpret_cast<uint64_t>(this) | MULTISHOT_TAG;
+    }
+
+    [[nodiscard]]
+    auto cancel_data() noexcept -> uint64_t {
+        return reinterpret_cast<uint64_t>(this) | CANCEL_TAG;
+    }
+
+    // Submit the request to `ring`, call with `mutex_` held
+    void arm(runtime::detail::IORing &ring) {
+        auto sqe = ring.get_sqe();
+        prep(sqe, ring);
+        apply_fixed_file(sqe);
+        io_uring_sqe_set_data64(sqe, user_data());
+        ring_ = &ring;
+        ring.submit();
+    }
+
+    // Drop queued completions the owner should never see
+    void prune() noexcept {}
+
+    // Arm again once the kernel ended the request, by default after a pause
+    // only when half the queue is drained
+    [[nodiscard]]
+    auto should_rearm() noexcept -> bool {
+        return completions_.size() <= max_pending_ / 2;
+    }
+
+    // The stream is over, `take` reports its end with an empty queue
+    [[nodiscard]]
+    auto done() noexcept -> bool {
+        return false;
+    }
+
+    // Called by the owner when it goes away. Queued completions are discarded,
+    // a callback still armed is freed by the driver after its last completion.
+    static void release(MultishotCallback *cb) {
+        std::unique_lock lock{cb->mutex_};
+        for (const auto &completion : cb->completions_) {
+            cb->discard(completion);
+        }
+        cb->completions_.clear();
+        if (cb->ring_ != nullptr) {
+            // The last completion cannot be reaped before the lock is released
+            cb->orphaned_ = true;
+            auto ring = runtime::detail::t_ring;
+            if (ring == cb->ring_ || ring == nullptr) {
+                cb->ring_->cancel(cb->user_data());
+            } else {
+                // Single issuer rings only take requests from their own
+                // thread, the driver of the armed ring cancels for us
+                cb->forwarded_ = true;
+                ring->msg_ring(cb->ring_->fd(), cb->cancel_data());
+            }
+        } else {
+            lock.unlock();
+            delete cb;
+        }
+    }
+
+    // A cancel forwarded by `release` arrived at the armed ring, or came back
+    // undelivered to the forwarding ring with `result` < 0, which then
+    // cancels synchronously. Returns true if the request already ended and
+    // the callback is to be deleted.
+    [[nodiscard]]
+    static auto cancel_forwarded(MultishotCallback *cb, int result) -> bool {
+        std::lock_guard lock{cb->mutex_};
+        cb->forwarded_ = false;
+        if (cb->ring_ == nullptr) {
+            return true;
+        }
+        if (result < 0) [[unlikely]] {
+            LOG_ERROR("forward cancel failed, error: {}", strerror(-result));
+        }
+        cb->ring_->cancel(cb->user_data());
+        return false;
+    }
+
+    std::mutex               mutex_{};
+    std::coroutine_handle<>  handle_{nullptr};
+    std::deque<Completion>   completions_{};
+    // Ring the request is armed on, nullptr once the kernel posted the last completion
+    runtime::detail::IORing *ring_{nullptr};
+    // The driver cancels the request when this many completions are queued,
+    // the owner arms it again once it caught up
+    std::size_t              max_pending_{std::numeric_limits<std::size_t>::max()};
+    // Cancelled because of `max_pending_`
+    bool                     paused_{false};
+    // The owner is gone, the driver deletes the callback after the last completion
+    bool                     orphaned_{false};
+    // A cancel is on its way to `ring_`, which deletes the callback instead
+    bool                     forwarded_{false};
+};
+
+/// The owner of a `MultishotCallback`, `next()` yields one completion at a
+/// time and only suspends when the queue is empty.
+template <class Callback>
+class MultishotStream : util::Noncopyable {
+public:
+    class Awaiter {
+    public:
+        explicit Awaiter(Callback *cb)
+            : cb_{cb} {}
+
+        auto await_ready() -> bool {
+            std::lock_guard lock{cb_->mutex_};
+            cb_->prune();
+            if (cb_->ring_ == nullptr && !cb_->done() && cb_->should_rearm()) {
+                cb_->paused_ = false;
+                cb_->arm(*runtime::detail::t_ring);
+            }
+            return !cb_->completions_.empty() || cb_->done();
+        }
+
+        auto await_suspend(std::coroutine_handle<> handle) -> bool {
+            std::lock_guard lock{cb_->mutex_};
+            // Completed between await_ready and now
+            if (!cb_->completions_.empty()) {
+                return false;
+            }
+            cb_->handle_ = handle;
+            return true;
+        }
+
+        auto await_resume() {
+            std::lock_guard lock{cb_->mutex_};
+            return cb_->take();
+        }
+
+    private:
+        Callback *cb_;
+    };
+
+public:
+    template <typename... Args>
+        requires std::constructible_from<Callback, Args...>
+    explicit MultishotStream(Args &&...args)
+        : cb_{new Callback{std::forward<Args>(args)...}} {}
+
+    MultishotStream(MultishotStream &&other) noexcept
+        : cb_{std::exchange(other.cb_, nullptr)} {}
+
+    auto operator=(MultishotStream &&other) noexcept -> MultishotStream & {
+        if (this != &other) {
+            release();
+            cb_ = std::exchange(other.cb_, nullptr);
+        }
+        return *this;
+    }
+
+    ~MultishotStream() {
+        release();
+    }
+
+public:
+    [[REMEMBER_CO_AWAIT]]
+    auto next() noexcept {
+        return Awaiter{cb_};
+    }
+
+private:
+    void release() {
+        if (cb_ != nullptr) {
+            MultishotCallback::release(std::exchange(cb_, nullptr));
+        }
+    }
+
+private:
+    Callback *cb_;
+};
+
+} // namespace zedio::io::detail
@@ -5,6 +5,7 @@
 #include "zedio/common/macros.hpp"
 #include "zedio/common/util/noncopyable.hpp"
 #include "zedio/io/base/callback.hpp"
+#include "zedio/io/base/fixed_file.hpp"
 #include "zedio/runtime/driver.hpp"
 #include "zedio/time/timeout.hpp"
 
@@ -12,19 +13,23 @@ using namespace std::chrono_literals;
 
 namespace zedio::io::detail {
 
+template <class... IOs>
+class Chain;
+
 template <class IO>
 class IORegistrator {
+    template <class... IOs>
+    friend class Chain;
+
 public:
     template <typename F, typename... Args>
         requires std::is_invocable_v<F, io_uring_sqe *, Args...>
     IORegistrator(F &&f, Args... args)
         : sqe_{runtime::detail::t_ring->get_sqe()} {
-        if (sqe_ != nullptr) [[likely]] {
-            std::invoke(std::forward<F>(f), sqe_, std::forward<Args>(args)...);
-            io_uring_sqe_set_data(sqe_, &this->cb_);
-        } else {
-            cb_.result_ = -Error::EmptySqe;
-        }
+        // The ring queues sqes in memory when the SQ is full, so sqe_ is never null
+        std::invoke(std::forward<F>(f), sqe_, std::forward<Args>(args)...);
+        io_uring_sqe_set_data(sqe_, &this->cb_);
+        apply_fixed_file(sqe_);
     }
 
     // Delete copy
@@ -63,9 +68,18 @@ public:
         return time::detail::Timeout{std::move(*static_cast<IO *>(this))};
     }
 
+    // Rounded up to the clock, a timeout never fires early
+    template <class Rep, class Period>
+    [[REMEMBER_CO_AWAIT]]
+    auto set_timeout(std::chrono::duration<Rep, Period> interval) noexcept {
+        return set_timeout_at(runtime::detail::timer_now()
+                              + std::chrono::ceil<std::chrono::steady_clock::duration>(interval));
+    }
+
+    // Let the kernel time the operation out, see `time::detail::LinkTimeout`
     [[REMEMBER_CO_AWAIT]]
-    auto set_timeout(std::chrono::milliseconds interval) noexcept {
-        return set_timeout_at(std::chrono::steady_clock::now() + interval);
+    auto set_link_timeout(std::chrono::nanoseconds interval) {
+        return time::detail::LinkTimeout{std::move(*static_cast<IO *>(this)), interval};
     }
 
 protected:
@@ -14,6 +14,7 @@
 #include "zedio/io/awaiter/link.hpp"
 #include "zedio/io/awaiter/mkdir.hpp"
 #include "zedio/io/awaiter/open.hpp"
+#include "zedio/io/awaiter/poll_multishot.hpp"
 #include "zedio/io/awaiter/read.hpp"
 #include "zedio/io/awaiter/readv.hpp"
 #include "zedio/io/awaiter/recv.hpp"
@@ -31,6 +32,7 @@
 #include "zedio/io/awaiter/waitid.hpp"
 #include "zedio/io/awaiter/write.hpp"
 #include "zedio/io/awaiter/writev.hpp"
+#include "zedio/io/base/chain.hpp"
 
 namespace zedio::io::detail {
 
@@ -85,7 +87,14 @@ public:
 
     [[nodiscard]]
     auto set_nonblocking(bool status) const noexcept -> Result<void> {
+        // A fixed file only exists in the ring, plain syscalls can not reach it
+        if (is_fixed_file(fd_)) [[unlikely]] {
+            return std::unexpected{make_sys_error(EBADF)};
+        }
         auto flags = ::fcntl(fd_, F_GETFL, 0);
+        if (flags == -1) [[unlikely]] {
+            return std::unexpected{make_sys_error(errno)};
+        }
         if (status) {
             flags |= O_NONBLOCK;
         } else {
@@ -99,6 +108,9 @@ public:
 
     [[nodiscard]]
     auto nonblocking() const noexcept -> Result<bool> {
+        if (is_fixed_file(fd_)) [[unlikely]] {
+            return std::unexpected{make_sys_error(EBADF)};
+        }
         auto flags = ::fcntl(fd_, F_GETFL, 0);
         if (flags == -1) [[unlikely]] {
             return std::unexpected{make_sys_error(errno)};
@@ -108,13 +120,19 @@ public:
 
 private:
     void do_close() noexcept {
-        auto sqe = runtime::detail::t_ring->get_sqe();
-        if (sqe != nullptr) [[likely]] {
+        if (runtime::detail::t_ring != nullptr) [[likely]] {
             // async close
-            io_uring_prep_close(sqe, fd_);
+            auto sqe = runtime::detail::t_ring->get_sqe();
+            if (is_fixed_file(fd_)) {
+                io_uring_prep_close_direct(sqe, static_cast<unsigned>(fixed_file_index(fd_)));
+            } else {
+                io_uring_prep_close(sqe, fd_);
+            }
             io_uring_sqe_set_data(sqe, nullptr);
+        } else if (is_fixed_file(fd_)) {
+            LOG_ERROR("fixed file {} can not be closed outside of its runtime", fd_);
         } else {
-            // sync close
+            // sync close outside of the runtime
             for (auto i = 1; i <= 3; i += 1) {
                 auto ret = ::close(fd_);
                 if (ret == 0) [[likely]] {
@@ -6,8 +6,17 @@
 #include "zedio/runtime/runtime.hpp"
 
 // C++
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <format>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <thread>
+#include <vector>
+// Linux
+#include <liburing.h>
 
 namespace zedio::runtime {
 
@@ -37,11 +46,105 @@ namespace detail {
         }
 
         [[nodiscard]]
-        auto set_submit_interval(std::size_t interval) {
+        auto set_submit_interval(uint32_t interval) -> Builder & {
             config_.submit_interval_ = interval;
             return *this;
         }
 
+        // Run the kernel SQPOLL thread on `cpu`, this turns on
+        // IORING_SETUP_SQPOLL
+        [[nodiscard]]
+        auto set_sq_thread_cpu(uint32_t cpu) -> B & {
+            config_.sq_thread_cpu_ = cpu;
+            return static_cast<B &>(*this);
+        }
+
+        // Poll the submission queues from a kernel thread, which sleeps after
+        // `idle_ms` milliseconds without work. The rings of all workers share
+        // one thread. Not compatible with defer taskrun, `build` throws
+        // std::invalid_argument for both.
+        [[nodiscard]]
+        auto set_sqpoll(uint32_t idle_ms) -> B & {
+            config_.ring_flags_ |= IORING_SETUP_SQPOLL;
+            config_.sq_thread_idle_ = idle_ms;
+            return static_cast<B &>(*this);
+        }
+
+        // Run completion task work when the worker enters the kernel anyway,
+        // instead of interrupting it. Requires Linux 5.19.
+        [[nodiscard]]
+        auto set_coop_taskrun(bool on) -> B & {
+            return set_ring_flag(IORING_SETUP_COOP_TASKRUN, on);
+        }
+
+        // Only the worker that owns a ring submits to it. Requires Linux 6.0.
+        [[nodiscard]]
+        auto set_single_issuer(bool on) -> B & {
+            return set_ring_flag(IORING_SETUP_SINGLE_ISSUER, on);
+        }
+
+        // Defer completion task work until the worker polls the ring, implies
+        // single issuer. Requires Linux 6.1, not compatible with SQPOLL.
+        [[nodiscard]]
+        auto set_defer_taskrun(bool on) -> B & {
+            if (on) {
+                config_.ring_flags_ |= IORING_SETUP_SINGLE_ISSUER;
+            }
+            return set_ring_flag(IORING_SETUP_DEFER_TASKRUN, on);
+        }
+
+        // Give every ring `num` buffers of `size` bytes for multishot recv,
+        // `num` is rounded up to a power of two. Requires Linux 6.0.
+        [[nodiscard]]
+        auto set_provided_buffers(uint32_t num, uint32_t size) -> B & {
+            config_.num_provided_buffers_ = num == 0 ? 0 : std::bit_ceil(num);
+            config_.provided_buffer_size_ = size;
+            return static_cast<B &>(*this);
+        }
+
+        // Register `num` buffers of `size` bytes with every ring, leased with
+        // `io::FixedBuffer::lease()`. At most 16384 buffers, sizes are rounded
+        // up to a page.
+        [[nodiscard]]
+        auto set_registered_buffers(uint32_t num, uint32_t size) -> B & {
+            config_.num_registered_buffers_ = num;
+            config_.registered_buffer_size_ = size;
+            return static_cast<B &>(*this);
+        }
+
+        // Tick of the timer wheel and of the io_uring wait timeout, at least a
+        // microsecond. Timeouts reach 2^42 ticks ahead, ~139 years at the
+        // default millisecond, ~50 days at a microsecond. Ticks coarser than
+        // Timer::MAX_RESOLUTION, just above a millisecond, would overflow the
+        // clock that far ahead and throw std::invalid_argument.
+        [[nodiscard]]
+        auto set_timer_resolution(std::chrono::nanoseconds resolution) -> B & {
+            if (resolution > Timer::MAX_RESOLUTION) [[unlikely]] {
+                throw std::invalid_argument(
+                    std::format("Timer resolution {}ns is coarser than the maximum {}ns.",
+                                resolution.count(),
+                                Timer::MAX_RESOLUTION.count()));
+            }
+            config_.timer_resolution_
+                = std::max<std::chrono::nanoseconds>(resolution, std::chrono::microseconds{1});
+            return static_cast<B &>(*this);
+        }
+
+        // Deadlines of sleeps and timeouts count from the clock read at the
+        // last poll by default, which may lag by one round of tasks. Precise
+        // timers read the clock on every operation instead.
+        [[nodiscard]]
+        auto set_precise_timer(bool on) -> B & {
+            config_.precise_timer_ = on;
+            return static_cast<B &>(*this);
+        }
+
+        [[nodiscard]]
+        auto set_cq_entries(uint32_t entries) -> B & {
+            config_.cq_entries_ = entries;
+            return static_cast<B &>(*this);
+        }
+
         [[nodiscard]]
         auto set_thread_name_fn(std::function<std::string(std::size_t)> &&func) -> Builder & {
             build_thread_name_func_ = std::move(func);
@@ -58,6 +161,16 @@ namespace detail {
 
         [[nodiscard]]
         auto build() {
+            auto sqpoll = (config_.ring_flags_ & IORING_SETUP_SQPOLL) || config_.sq_thread_cpu_;
+            if (sqpoll && (config_.ring_flags_ & IORING_SETUP_DEFER_TASKRUN)) [[unlikely]] {
+                throw std::invalid_argument(
+                    "SQPOLL and defer taskrun cannot be used together, the kernel refuses "
+                    "IORING_SETUP_DEFER_TASKRUN with IORING_SETUP_SQPOLL.");
+            }
+            if (config_.num_registered_buffers_ > 0 && config_.registered_buffer_size_ > 0) {
+                config_.buffer_pool_ = std::make_shared<BufferPool>(
+                    config_.num_registered_buffers_, config_.registered_buffer_size_);
+            }
             return Runtime<H>{std::move(config_), std::move(build_thread_name_func_)};
         }
 
@@ -72,6 +185,16 @@ namespace detail {
             return B{}.build();
         }
 
+    private:
+        auto set_ring_flag(uint32_t flag, bool on) -> B & {
+            if (on) {
+                config_.ring_flags_ |= flag;
+            } else {
+                config_.ring_flags_ &= ~flag;
+            }
+            return static_cast<B &>(*this);
+        }
+
     protected:
         detail::Config                          config_{};
         std::function<std::string(std::size_t)> build_thread_name_func_{};
@@ -80,6 +203,15 @@ namespace detail {
 } // namespace detail
 
 class CurrentThreadBuilder : public detail::Builder<CurrentThreadBuilder, current_thread::Handle> {
+public:
+    // Register a sparse fixed file table of `num` slots with the ring, used by
+    // `accept_direct` and `File::options().direct(true)`. Fixed files belong to
+    // one ring, so this is only offered where tasks never leave their thread.
+    [[nodiscard]]
+    auto set_fixed_files(uint32_t num) -> CurrentThreadBuilder & {
+        config_.num_fixed_files_ = num;
+        return *this;
+    }
 };
 
 class MultiThreadBuilder : public detail::Builder<MultiThreadBuilder, multi_thread::Handle> {
@@ -89,6 +221,49 @@ public:
         config_.num_workers_ = num_worker_threads;
         return *this;
     }
+
+    // Capacity of each worker's local queue, rounded up to a power of two.
+    // Larger queues spill less often to the global queue but give stealers
+    // bigger batches to take.
+    [[nodiscard]]
+    auto set_local_queue_capacity(std::size_t capacity) -> MultiThreadBuilder & {
+        config_.local_queue_capacity_ = std::bit_ceil(std::max(capacity, 2uz));
+        return *this;
+    }
+
+    // Post tasks for sleeping workers straight into their io_uring with
+    // IORING_OP_MSG_RING instead of the queues and an eventfd wake up.
+    // Requires Linux 5.18.
+    [[nodiscard]]
+    auto set_msg_ring(bool on) -> MultiThreadBuilder & {
+        config_.msg_ring_ = on;
+        return *this;
+    }
+
+    // Restrict workers to `cpus`. With `pin_workers(true)` worker N is bound
+    // to cpus[N % cpus.size()], otherwise every worker may run on the whole set.
+    [[nodiscard]]
+    auto set_cpu_affinity(std::vector<int> cpus) -> MultiThreadBuilder & {
+        config_.cpu_affinity_ = std::move(cpus);
+        return *this;
+    }
+
+    // Bind each worker to a single cpu, taken from `set_cpu_affinity` or
+    // from all cpus the process may run on
+    [[nodiscard]]
+    auto pin_workers(bool on) -> MultiThreadBuilder & {
+        config_.pin_workers_ = on;
+        return *this;
+    }
+
+    // Pin workers to cpus read from /sys/devices/system/cpu, grouped by NUMA
+    // node and last level cache. Workers steal from siblings sharing their
+    // cache first, then from their node, and only then across nodes.
+    [[nodiscard]]
+    auto set_topology_aware_stealing(bool on) -> MultiThreadBuilder & {
+        config_.topology_aware_ = on;
+        return *this;
+    }
 };
 
 } // namespace zedio::runtime
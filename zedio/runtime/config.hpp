@@ -1,8 +1,13 @@
 #pragma once
 
+#include "zedio/runtime/io/buffer_pool.hpp"
 // C++
+#include <chrono>
 #include <format>
+#include <memory>
+#include <optional>
 #include <thread>
+#include <vector>
 
 namespace zedio::runtime::detail {
 
@@ -11,9 +16,15 @@ namespace zedio::runtime::detail {
 static inline constexpr std::size_t MAX_LEVEL{6uz};
 // size of slot per wheel
 static inline constexpr std::size_t SLOT_SIZE{64uz};
+// Max entries a poll cascades down the wheel, the rest wait for the next polls
+static inline constexpr std::size_t TIMER_CASCADE_BUDGET{4096uz};
 
 /// Queue
+// Default capacity of a worker's local queue, must be a power of two
 static inline constexpr std::size_t LOCAL_QUEUE_CAPACITY{256uz};
+// Must be a power of two, tasks beyond it spill to a locked list until the
+// ring has room again
+static inline constexpr std::size_t GLOBAL_QUEUE_CAPACITY{16384uz};
 
 struct Config {
     // size of io_uring_queue entries
@@ -21,6 +32,7 @@ struct Config {
 
     // TODO if linux
     //  io_uring flags
+    // Max sqes batched per submit while other tasks are runnable, 0 for no limit
     uint32_t submit_interval_{4};
     // num of worker
     std::size_t num_workers_{std::thread::hardware_concurrency()};
@@ -28,6 +40,38 @@ struct Config {
     uint32_t io_interval_{61};
     // How many ticks worker to pop global queue
     uint32_t global_queue_interval_{61};
+    // Capacity of each worker's local queue, always a power of two
+    std::size_t local_queue_capacity_{LOCAL_QUEUE_CAPACITY};
+    // Hand tasks to sleeping workers with IORING_OP_MSG_RING
+    bool msg_ring_{false};
+    // Pin workers along the cpu topology and steal from the nearest workers first
+    bool topology_aware_{false};
+    // Cpus the workers may run on, empty for no restriction
+    std::vector<int> cpu_affinity_{};
+    // Bind each worker to a single cpu
+    bool pin_workers_{false};
+    // Cpu of the kernel SQPOLL thread, setting it enables SQPOLL
+    std::optional<uint32_t> sq_thread_cpu_{};
+    // IORING_SETUP_* flags of every ring
+    uint32_t ring_flags_{0};
+    // Milliseconds the SQPOLL thread spins before sleeping, 0 for the kernel default
+    uint32_t sq_thread_idle_{0};
+    // Size of the completion queue, 0 for twice `num_events_`
+    uint32_t cq_entries_{0};
+    // Slots of the sparse fixed file table registered with the ring
+    uint32_t num_fixed_files_{0};
+    // Provided buffers per ring for multishot recv, a power of two, 0 for none
+    uint32_t num_provided_buffers_{0};
+    uint32_t provided_buffer_size_{4096};
+    // Buffers registered with every ring for read_fixed and write_fixed
+    uint32_t num_registered_buffers_{0};
+    uint32_t registered_buffer_size_{0};
+    // Tick of the timer wheels and of the io_uring wait timeout
+    std::chrono::nanoseconds timer_resolution_{std::chrono::milliseconds{1}};
+    // Read the clock on every timer operation instead of once per poll
+    bool precise_timer_{false};
+    // Shared by all rings of a runtime, created when the runtime is built
+    std::shared_ptr<BufferPool> buffer_pool_{};
 };
 
 } // namespace zedio::runtime::detail
@@ -56,12 +100,46 @@ public:
                          num_workers: {},
                          io_interval: {},
                          global_queue_interval: {},
-                         submit_interval: {})",
+                         submit_interval: {},
+                         local_queue_capacity: {},
+                         msg_ring: {},
+                         topology_aware: {},
+                         num_affinity_cpus: {},
+                         pin_workers: {},
+                         sq_thread_cpu: {},
+                         ring_flags: {:#x},
+                         sq_thread_idle: {},
+                         cq_entries: {},
+                         num_fixed_files: {},
+                         num_provided_buffers: {},
+                         provided_buffer_size: {},
+                         num_registered_buffers: {},
+                         registered_buffer_size: {},
+                         timer_resolution: {},
+                         precise_timer: {})",
                          config.num_events_,
                          config.num_workers_,
                          config.io_interval_,
                          config.global_queue_interval_,
-                         config.submit_interval_);
+                         config.submit_interval_,
+                         config.local_queue_capacity_,
+                         config.msg_ring_,
+                         config.topology_aware_,
+                         config.cpu_affinity_.size(),
+                         config.pin_workers_,
+                         config.sq_thread_cpu_.has_value()
+                             ? static_cast<int64_t>(config.sq_thread_cpu_.value())
+                             : -1,
+                         config.ring_flags_,
+                         config.sq_thread_idle_,
+                         config.cq_entries_,
+                         config.num_fixed_files_,
+                         config.num_provided_buffers_,
+                         config.provided_buffer_size_,
+                         config.num_registered_buffers_,
+                         config.registered_buffer_size_,
+                         config.timer_resolution_,
+                         config.precise_timer_);
     }
 };
 
@@ -28,6 +28,11 @@ public:
         worker_.run();
     }
 
+    [[nodiscard]]
+    auto stats() -> detail::SubmitStats {
+        return worker_.stats();
+    }
+
 public:
     Worker worker_;
 };
@@ -1,11 +1,14 @@
 #pragma once
 
 // C++
+#include <atomic>
 #include <coroutine>
+#include <limits>
 #include <list>
 #include <mutex>
 #include <optional>
 #include <queue>
+#include <span>
 
 namespace zedio::runtime::current_thread {
 
@@ -104,6 +107,18 @@ public:
         }
     }
 
+    void push_batch(std::span<const std::coroutine_handle<>> handles) {
+        for (auto handle : handles) {
+            tasks_.push(handle);
+        }
+    }
+
+    // Unbounded, the driver may hand over any number of tasks
+    [[nodiscard]]
+    auto remaining_slots() const noexcept -> std::size_t {
+        return std::numeric_limits<std::size_t>::max();
+    }
+
     [[nodiscard]]
     auto pop() -> std::optional<std::coroutine_handle<>> {
         std::optional<std::coroutine_handle<>> result{std::nullopt};
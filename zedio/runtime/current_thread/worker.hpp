@@ -48,6 +48,11 @@ public:
         driver_.wake_up();
     }
 
+    [[nodiscard]]
+    auto stats() const noexcept -> detail::SubmitStats {
+        return driver_.stats();
+    }
+
     void close() {
         if (global_queue_.close()) {
             wake_up();
@@ -74,6 +79,8 @@ public:
 
 private:
     void execute_task(std::coroutine_handle<> task) {
+        driver_.set_num_runnable(static_cast<std::size_t>(run_next_.has_value())
+                                 + local_queue_.size());
         task.resume();
     }
 
@@ -1,18 +1,23 @@
 #pragma once
 
 #include "zedio/io/base/callback.hpp"
+#include "zedio/io/base/multishot.hpp"
 #include "zedio/runtime/io/io_uring.hpp"
 #include "zedio/runtime/io/waker.hpp"
 #include "zedio/runtime/timer/timer.hpp"
 // C
 #include <cstring>
 // C++
+#include <algorithm>
 #include <chrono>
+#include <coroutine>
 #include <expected>
 #include <format>
 #include <functional>
 #include <numeric>
 #include <queue>
+#include <utility>
+#include <vector>
 // Linux
 #include <liburing.h>
 #include <sys/eventfd.h>
@@ -25,9 +30,11 @@ inline thread_local Driver *t_driver{nullptr};
 
 class Driver {
 public:
-    Driver(const Config &config)
-        : ring_{config} {
+    Driver(const Config &config, int wq_fd = -1)
+        : ring_{config, wq_fd}
+        , timer_{config.timer_resolution_, config.precise_timer_} {
         assert(t_driver == nullptr);
+        ready_.reserve(config.local_queue_capacity_);
         t_driver = this;
     }
 
@@ -40,29 +47,47 @@ public:
     // until other worker wakes up it or a I/O event completes
     template <typename LocalQueue, typename GlobalQueue>
     void wait(LocalQueue &local_queue, GlobalQueue &global_queue) {
-        ring_.wait(timer_.next_expiration_time());
+        ring_.flush();
+        // Skip blocking if someone notified us after we last polled
+        if (waker_.try_park()) {
+            // Tasks ran since the last poll, do not oversleep
+            timer_.update_now();
+            auto timeout = timer_.next_expiration_time();
+            // Come back soon to move the remaining backlog into the SQ
+            if (ring_.has_backlog()) {
+                timeout = std::min<std::chrono::nanoseconds>(
+                    timeout.value_or(std::chrono::milliseconds{1}), std::chrono::milliseconds{1});
+            }
+            ring_.wait(timeout);
+        }
+        waker_.unpark();
         poll(local_queue, global_queue);
     }
 
     template <typename LocalQueue, typename GlobalQueue>
     auto poll(LocalQueue &local_queue, GlobalQueue &global_queue) -> bool {
-        constexpr const auto             SIZE = LOCAL_QUEUE_CAPACITY;
-        std::array<io_uring_cqe *, SIZE> cqes;
+        timer_.update_now();
 
-        std::size_t cnt = ring_.peek_batch(cqes);
-        for (auto i = 0uz; i < cnt; i += 1) {
-            auto cb = reinterpret_cast<io::detail::Callback *>(cqes[i]->user_data);
-            if (cb != nullptr) [[likely]] {
-                if (cb->entry_ != nullptr) {
-                    timer_.remove_entry(cb->entry_);
-                }
-                cb->result_ = cqes[i]->res;
-                local_queue.push_back_or_overflow(cb->handle_, global_queue);
+        std::size_t cnt{0};
+        // Drain the cq as far as the local queue has room. Every cqe wakes at
+        // most one task, so a round never spills into the global queue, cqes
+        // left behind are reaped on the next poll.
+        while (true) {
+            auto room = std::min(local_queue.remaining_slots(), ready_.capacity());
+            if (room == 0) {
+                break;
+            }
+            auto n = ring_.reap(room, [this](io_uring_cqe *cqe) { handle_cqe(cqe); });
+            if (!ready_.empty()) {
+                local_queue.push_batch(ready_);
+                ready_.clear();
+            }
+            cnt += n;
+            if (n < room) {
+                break;
             }
         }
 
-        ring_.consume(cnt);
-
         auto timer_cnt = timer_.handle_expired_entries(local_queue, global_queue);
 
         LOG_TRACE("poll {} io events, {} timer events", cnt, timer_cnt);
@@ -71,7 +96,7 @@ public:
 
         waker_.turn_on();
 
-        ring_.force_submit();
+        ring_.flush();
 
         return cnt > 0;
     }
@@ -80,10 +105,175 @@ public:
         return waker_.wake_up();
     }
 
+    void set_num_runnable(std::size_t num_runnable) {
+        ring_.set_num_runnable(num_runnable);
+    }
+
+    void flush() {
+        ring_.flush();
+    }
+
+    [[nodiscard]]
+    auto ring_fd() const noexcept -> int {
+        return ring_.fd();
+    }
+
+    [[nodiscard]]
+    auto stats() const noexcept -> SubmitStats {
+        return ring_.stats();
+    }
+
+    /// Whether `post_task` can carry `task`, its address has to leave room
+    /// for the target in the top bits
+    [[nodiscard]]
+    static auto can_post_task(std::coroutine_handle<> task) noexcept -> bool {
+        return (reinterpret_cast<uint64_t>(task.address()) >> POST_TARGET_SHIFT) == 0;
+    }
+
+    /// Post `task` to the completion queue of the ring of worker `target`,
+    /// whose driver will schedule it on its next poll. Submitted right away,
+    /// the target worker is asleep and waits for nothing else. If the post
+    /// fails, the task comes back to this driver and `target` is reported by
+    /// `take_failed_posts`.
+    void post_task(int ring_fd, std::size_t target, std::coroutine_handle<> task) {
+        auto address = reinterpret_cast<uint64_t>(task.address());
+        assert((address & io::detail::TAG_MASK) == 0 && can_post_task(task));
+        assert(target < (1uz << (64 - POST_TARGET_SHIFT)));
+        ring_.msg_ring(ring_fd,
+                       address | (static_cast<uint64_t>(target) << POST_TARGET_SHIFT)
+                           | io::detail::TASK_TAG);
+    }
+
+    /// Targets of the posts that came back failed since the last call, they
+    /// never got their task and were not woken up
+    [[nodiscard]]
+    auto take_failed_posts() -> std::vector<std::size_t> {
+        return std::exchange(failed_posts_, {});
+    }
+
+private:
+    void handle_cqe(io_uring_cqe *cqe) {
+        auto data = cqe->user_data;
+        switch (data & io::detail::TAG_MASK) {
+        case io::detail::CALLBACK_TAG: {
+            auto cb = reinterpret_cast<io::detail::Callback *>(data);
+            if (cb == nullptr) [[unlikely]] {
+                break;
+            }
+            // A zero copy send releases the buffer with a second CQE, the
+            // result came with the first one
+            if (!(cqe->flags & IORING_CQE_F_NOTIF)) {
+                if (cb->entry_ != nullptr) {
+                    timer_.remove_entry(std::exchange(cb->entry_, nullptr));
+                }
+                cb->result_ = cqe->res;
+                // The kernel still holds the buffer, wait for the notification
+                if (cqe->flags & IORING_CQE_F_MORE) {
+                    break;
+                }
+            }
+            // The last completion of a chain resumes the task, whichever
+            // operation it belongs to
+            if (cb->num_pending_ != nullptr && --*cb->num_pending_ > 0) {
+                break;
+            }
+            if (cb->handle_ != nullptr) {
+                ready_.push_back(cb->handle_);
+            }
+            break;
+        }
+        case io::detail::TASK_TAG:
+            // A failed hand-off comes back to the source ring, keep the task
+            if (cqe->res < 0) [[unlikely]] {
+                LOG_DEBUG("msg_ring failed, error: {}", strerror(-cqe->res));
+                failed_posts_.push_back(static_cast<std::size_t>(data >> POST_TARGET_SHIFT));
+            }
+            ready_.push_back(to_task(data));
+            break;
+        case io::detail::MULTISHOT_TAG:
+            handle_multishot(cqe);
+            break;
+        case io::detail::CANCEL_TAG: {
+            auto cb = reinterpret_cast<io::detail::MultishotCallback *>(data
+                                                                        & ~io::detail::TAG_MASK);
+            if (io::detail::MultishotCallback::cancel_forwarded(cb, cqe->res)) {
+                delete cb;
+            }
+            break;
+        }
+        default:
+            std::unreachable();
+        }
+    }
+
+    void handle_multishot(io_uring_cqe *cqe) {
+        auto cb = reinterpret_cast<io::detail::MultishotCallback *>(cqe->user_data
+                                                                    & ~io::detail::TAG_MASK);
+        io::detail::MultishotCallback::Completion completion{cqe->res, cqe->flags};
+        auto more = (cqe->flags & IORING_CQE_F_MORE) != 0;
+        std::coroutine_handle<> handle{nullptr};
+        bool                    orphaned{false};
+        bool                    forwarded{false};
+        {
+            std::lock_guard lock{cb->mutex_};
+            if (!more) {
+                cb->ring_ = nullptr;
+            }
+            orphaned = cb->orphaned_;
+            forwarded = cb->forwarded_;
+            if (orphaned) {
+                cb->discard(completion);
+            } else if (cb->paused_ && !more) {
+                cb->paused_ = false;
+                // Cancelled by us, not a failure of the request
+                if (completion.result_ != -ECANCELED) {
+                    cb->completions_.push_back(completion);
+                }
+                // The owner caught up while the cancel was in flight
+                if (cb->completions_.empty() && cb->handle_ != nullptr) {
+                    cb->arm(ring_);
+                }
+            } else {
+                cb->completions_.push_back(completion);
+                if (more && !cb->paused_ && cb->completions_.size() >= cb->max_pending_) {
+                    cb->paused_ = true;
+                    ring_.cancel(cb->user_data());
+                }
+            }
+            // Resume the owner once, however many completions arrive before it runs
+            if (!cb->completions_.empty()) {
+                handle = std::exchange(cb->handle_, nullptr);
+            }
+        }
+        if (handle != nullptr) {
+            ready_.push_back(handle);
+        }
+        // Otherwise the forwarded cancel deletes it when it arrives
+        if (orphaned && !more && !forwarded) {
+            delete cb;
+        }
+    }
+
+    [[nodiscard]]
+    static auto to_task(uint64_t data) -> std::coroutine_handle<> {
+        auto mask = ((uint64_t{1} << POST_TARGET_SHIFT) - 1) & ~io::detail::TAG_MASK;
+        auto address = reinterpret_cast<void *>(data & mask);
+        return std::coroutine_handle<>::from_address(address);
+    }
+
+private:
+    // A posted task carries its target worker above the address, user space
+    // addresses stay below 2^48 unless a larger address space is asked for
+    static constexpr uint64_t POST_TARGET_SHIFT{48};
+
 private:
-    IORing ring_;
-    Waker  waker_{};
-    Timer  timer_{};
+    IORing                               ring_;
+    Waker                                waker_{};
+    Timer                                timer_;
+    // Tasks woken by the cqes of the current round, handed over in one batch
+    std::vector<std::coroutine_handle<>> ready_{};
+    // Targets of failed posts, see `take_failed_posts`
+    std::vector<std::size_t>             failed_posts_{};
 };
 
 } // namespace zedio::runtime::detail
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "zedio/common/debug.hpp"
+// C
+#include <cstring>
+// C++
+#include <format>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+// Linux
+#include <liburing.h>
+
+namespace zedio::runtime::detail {
+
+/// A ring of provided buffers registered with one io_uring. The kernel picks
+/// a buffer when data arrives, so memory follows in-flight data instead of
+/// the number of pending reads.
+class BufRing {
+public:
+    // num_buffers must be a power of two
+    BufRing(struct io_uring *ring, uint32_t num_buffers, uint32_t buffer_size, uint16_t group_id)
+        : ring_{ring}
+        , num_buffers_{num_buffers}
+        , buffer_size_{buffer_size}
+        , group_id_{group_id}
+        , mask_{io_uring_buf_ring_mask(num_buffers)}
+        , buffers_{std::make_unique<char[]>(static_cast<std::size_t>(num_buffers) * buffer_size)} {
+        int ret{0};
+        buf_ring_ = io_uring_setup_buf_ring(ring_, num_buffers_, group_id_, 0, &ret);
+        if (buf_ring_ == nullptr) [[unlikely]] {
+            throw std::runtime_error(
+                std::format("Call io_uring_setup_buf_ring failed, error: {}.", strerror(-ret)));
+        }
+        for (auto i = 0u; i < num_buffers_; ++i) {
+            io_uring_buf_ring_add(buf_ring_,
+                                  data(static_cast<uint16_t>(i)).data(),
+                                  buffer_size_,
+                                  static_cast<unsigned short>(i),
+                                  mask_,
+                                  static_cast<int>(i));
+        }
+        io_uring_buf_ring_advance(buf_ring_, static_cast<int>(num_buffers_));
+    }
+
+    // Must be destroyed before the io_uring is torn down
+    ~BufRing() {
+        io_uring_free_buf_ring(ring_, buf_ring_, num_buffers_, group_id_);
+    }
+
+    BufRing(const BufRing &) = delete;
+    auto operator=(const BufRing &) -> BufRing & = delete;
+
+public:
+    [[nodiscard]]
+    auto group_id() const noexcept -> uint16_t {
+        return group_id_;
+    }
+
+    [[nodiscard]]
+    auto buffer_size() const noexcept -> uint32_t {
+        return buffer_size_;
+    }
+
+    [[nodiscard]]
+    auto data(uint16_t id) const noexcept -> std::span<char> {
+        return {buffers_.get() + static_cast<std::size_t>(id) * buffer_size_, buffer_size_};
+    }
+
+    /// Hand buffer `id` back to the kernel. Callable from any thread, a task
+    /// may have been stolen by another worker since it got the buffer.
+    void give_back(uint16_t id) {
+        std::lock_guard lock{mutex_};
+        io_uring_buf_ring_add(buf_ring_, data(id).data(), buffer_size_, id, mask_, 0);
+        io_uring_buf_ring_advance(buf_ring_, 1);
+    }
+
+private:
+    struct io_uring          *ring_;
+    struct io_uring_buf_ring *buf_ring_{nullptr};
+    uint32_t                  num_buffers_;
+    uint32_t                  buffer_size_;
+    uint16_t                  group_id_;
+    int                       mask_;
+    std::unique_ptr<char[]>   buffers_;
+    std::mutex                mutex_{};
+};
+
+} // namespace zedio::runtime::detail
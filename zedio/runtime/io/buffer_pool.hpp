@@ -0,0 +1,98 @@
+#pragma once
+
+// C
+#include <cstdlib>
+// C++
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+// Linux
+#include <sys/uio.h>
+
+namespace zedio::runtime::detail {
+
+/// Buffers registered with the ring of every worker. An index is valid on
+/// any ring of the runtime, so a task keeps its lease when it is stolen, and
+/// the kernel pins the pages once instead of on every operation.
+class BufferPool {
+public:
+    // The kernel accepts at most 16384 registered buffers
+    static constexpr uint32_t MAX_BUFFERS{16384};
+    // Buffers are page aligned, which also suits O_DIRECT
+    static constexpr std::size_t ALIGNMENT{4096};
+
+    BufferPool(uint32_t num_buffers, uint32_t buffer_size)
+        : num_buffers_{std::clamp(num_buffers, 1u, MAX_BUFFERS)}
+        , buffer_size_{(buffer_size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT}
+        , memory_{static_cast<char *>(std::aligned_alloc(ALIGNMENT, num_buffers_ * buffer_size_))} {
+        if (memory_ == nullptr) [[unlikely]] {
+            throw std::bad_alloc{};
+        }
+        iovecs_.reserve(num_buffers_);
+        free_.reserve(num_buffers_);
+        for (auto i = 0u; i < num_buffers_; ++i) {
+            iovecs_.push_back(iovec{
+                .iov_base = memory_.get() + static_cast<std::size_t>(i) * buffer_size_,
+                .iov_len = buffer_size_,
+            });
+            // Hand out low indexes first
+            free_.push_back(static_cast<uint16_t>(num_buffers_ - 1 - i));
+        }
+    }
+
+    BufferPool(const BufferPool &) = delete;
+    auto operator=(const BufferPool &) -> BufferPool & = delete;
+
+public:
+    [[nodiscard]]
+    auto iovecs() const noexcept -> std::span<const iovec> {
+        return iovecs_;
+    }
+
+    [[nodiscard]]
+    auto buffer_size() const noexcept -> std::size_t {
+        return buffer_size_;
+    }
+
+    [[nodiscard]]
+    auto data(uint16_t index) const noexcept -> std::span<char> {
+        return {static_cast<char *>(iovecs_[index].iov_base), buffer_size_};
+    }
+
+    // Lease a free buffer, callable from any thread
+    [[nodiscard]]
+    auto acquire() -> std::optional<uint16_t> {
+        std::lock_guard lock{mutex_};
+        if (free_.empty()) {
+            return std::nullopt;
+        }
+        auto index = free_.back();
+        free_.pop_back();
+        return index;
+    }
+
+    void release(uint16_t index) {
+        std::lock_guard lock{mutex_};
+        free_.push_back(index);
+    }
+
+private:
+    struct Free {
+        void operator()(char *p) const noexcept {
+            std::free(p);
+        }
+    };
+
+private:
+    uint32_t                      num_buffers_;
+    std::size_t                   buffer_size_;
+    std::unique_ptr<char[], Free> memory_;
+    std::vector<iovec>            iovecs_{};
+    std::mutex                    mutex_{};
+    std::vector<uint16_t>         free_{};
+};
+
+} // namespace zedio::runtime::detail
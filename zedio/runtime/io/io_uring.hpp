@@ -2,32 +2,125 @@
 
 #include "zedio/common/debug.hpp"
 #include "zedio/runtime/config.hpp"
+#include "zedio/runtime/io/buf_ring.hpp"
 // C
 #include <cstring>
 // C++
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <deque>
 #include <format>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <utility>
 // Linux
 #include <liburing.h>
 
 namespace zedio::runtime::detail {
+
+/// Submit counters of a ring, or of all rings of a runtime
+struct SubmitStats {
+    // Calls of `submit` and `msg_ring`, each used to be a syscall of its own
+    std::size_t num_requests_{0};
+    std::size_t num_sqes_{0};
+    // Calls of io_uring_submit that entered the kernel, failed ones included.
+    // With SQPOLL the kernel thread picks sqes up and only waking it enters.
+    std::size_t num_syscalls_{0};
+
+    [[nodiscard]]
+    auto num_syscalls_saved() const noexcept -> std::size_t {
+        return num_requests_ - std::min(num_requests_, num_syscalls_);
+    }
+
+    auto operator+=(const SubmitStats &other) noexcept -> SubmitStats & {
+        num_requests_ += other.num_requests_;
+        num_sqes_ += other.num_sqes_;
+        num_syscalls_ += other.num_syscalls_;
+        return *this;
+    }
+};
+
 class IORing;
 
 inline thread_local IORing *t_ring{nullptr};
 
 class IORing {
 public:
-    IORing(const Config &config)
+    // With SQPOLL, a ring given by `wq_fd` lends its kernel thread to this one
+    IORing(const Config &config, int wq_fd = -1)
         : submit_interval_{config.submit_interval_} {
-        if (auto ret = io_uring_queue_init(config.num_events_, &ring_, 0); ret < 0) [[unlikely]] {
+        io_uring_params params{};
+        params.flags = config.ring_flags_;
+        if (config.sq_thread_cpu_) {
+            params.flags |= IORING_SETUP_SQPOLL | IORING_SETUP_SQ_AFF;
+            params.sq_thread_cpu = config.sq_thread_cpu_.value();
+        }
+        if (params.flags & IORING_SETUP_SQPOLL) {
+            params.sq_thread_idle = config.sq_thread_idle_;
+            // One SQPOLL thread polls all rings, rather than one per worker
+            // all spinning on the same cpu
+            if (wq_fd >= 0) {
+                params.flags |= IORING_SETUP_ATTACH_WQ;
+                params.wq_fd = static_cast<uint32_t>(wq_fd);
+            }
+        }
+        // Flag pending task work in the SQ ring, so `reap` knows it has to
+        // enter the kernel to run it
+        if (params.flags & (IORING_SETUP_COOP_TASKRUN | IORING_SETUP_DEFER_TASKRUN)) {
+            params.flags |= IORING_SETUP_TASKRUN_FLAG;
+        }
+        if (config.cq_entries_ > 0) {
+            params.flags |= IORING_SETUP_CQSIZE;
+            params.cq_entries = config.cq_entries_;
+        }
+        if (auto ret = io_uring_queue_init_params(config.num_events_, &ring_, &params); ret < 0)
+            [[unlikely]] {
             throw std::runtime_error(
-                std::format("Call io_uring_queue_init failed, error: {}.", strerror(-ret)));
+                std::format("Call io_uring_queue_init_params failed, error: {}.", strerror(-ret)));
+        }
+        if (config.num_fixed_files_ > 0) {
+            if (auto ret = io_uring_register_files_sparse(&ring_, config.num_fixed_files_);
+                ret < 0) [[unlikely]] {
+                io_uring_queue_exit(&ring_);
+                throw std::runtime_error(std::format(
+                    "Call io_uring_register_files_sparse failed, error: {}.", strerror(-ret)));
+            }
+        }
+        if (config.buffer_pool_) {
+            auto iovecs = config.buffer_pool_->iovecs();
+            if (auto ret = io_uring_register_buffers(
+                    &ring_, iovecs.data(), static_cast<unsigned>(iovecs.size()));
+                ret < 0) [[unlikely]] {
+                io_uring_queue_exit(&ring_);
+                throw std::runtime_error(std::format(
+                    "Call io_uring_register_buffers failed, error: {}.", strerror(-ret)));
+            }
+            buffer_pool_ = config.buffer_pool_;
+        }
+        if (config.num_provided_buffers_ > 0) {
+            try {
+                buf_ring_ = std::make_unique<BufRing>(
+                    &ring_, config.num_provided_buffers_, config.provided_buffer_size_, 0);
+            } catch (...) {
+                io_uring_queue_exit(&ring_);
+                throw;
+            }
         }
         assert(t_ring == nullptr);
         t_ring = this;
     }
 
     ~IORing() {
+        [[maybe_unused]] auto stats = this->stats();
+        LOG_DEBUG("submit stats: {} requests, {} sqes, {} syscalls, {} syscalls saved",
+                  stats.num_requests_,
+                  stats.num_sqes_,
+                  stats.num_syscalls_,
+                  stats.num_syscalls_saved());
+        buf_ring_.reset();
         io_uring_queue_exit(&ring_);
         t_ring = nullptr;
     }
@@ -38,14 +131,133 @@ public:
         return &ring_;
     }
 
+    [[nodiscard]]
+    auto fd() const noexcept -> int {
+        return ring_.ring_fd;
+    }
+
+    /// Provided buffers of this ring, nullptr unless configured
+    [[nodiscard]]
+    auto buf_ring() noexcept -> BufRing * {
+        return buf_ring_.get();
+    }
+
+    /// Buffers registered with this ring, nullptr unless configured
+    [[nodiscard]]
+    auto buffer_pool() noexcept -> BufferPool * {
+        return buffer_pool_.get();
+    }
+
+    /// Cancel the request tagged with `user_data` from the thread of this
+    /// ring. Other threads cancel synchronously, which single issuer rings
+    /// reject, workers forward the cancel with `msg_ring` instead.
+    void cancel(uint64_t user_data) {
+        if (t_ring == this) {
+            auto sqe = get_sqe();
+            io_uring_prep_cancel64(sqe, user_data, 0);
+            io_uring_sqe_set_data(sqe, nullptr);
+            submit();
+            return;
+        }
+        io_uring_sync_cancel_reg reg{};
+        reg.addr = user_data;
+        reg.timeout.tv_sec = -1;
+        reg.timeout.tv_nsec = -1;
+        if (auto ret = io_uring_register_sync_cancel(&ring_, &reg); ret < 0 && ret != -ENOENT)
+            [[unlikely]] {
+            LOG_ERROR("io_uring_register_sync_cancel failed, error: {}", strerror(-ret));
+        }
+    }
+
+    /// Post a cqe carrying `data` to the ring `ring_fd`, submitted right away.
+    /// If it cannot be delivered, a cqe with `data` and the error comes back
+    /// to this ring instead.
+    void msg_ring(int ring_fd, uint64_t data) {
+        auto sqe = get_sqe();
+        io_uring_prep_msg_ring(sqe, ring_fd, 0, data, 0);
+        io_uring_sqe_set_data64(sqe, data);
+        io_uring_sqe_set_flags(sqe, IOSQE_CQE_SKIP_SUCCESS);
+        count(stats_.num_requests_, 1);
+        force_submit();
+    }
+
+    /// Never returns nullptr. If the SQ is full, the sqe is queued in memory
+    /// and moved into the SQ by the next submit. Never submits by itself, so
+    /// sqes of awaiters that are not awaited yet stay unsubmitted and in order.
     [[nodiscard]]
     auto get_sqe() -> struct io_uring_sqe * {
-        return io_uring_get_sqe(&ring_);
+        if (backlog_.empty()) [[likely]] {
+            if (auto sqe = io_uring_get_sqe(&ring_); sqe != nullptr) [[likely]] {
+                return sqe;
+            }
+        }
+        // Stay behind the sqes already waiting, to keep the submission order
+        LOG_DEBUG("sq is full, {} sqes wait for room", backlog_.size() + 1);
+        return &backlog_.emplace_back();
+    }
+
+    /// Chain unsubmitted `sqes` with `flag`, IOSQE_IO_LINK or IOSQE_IO_HARDLINK.
+    /// The evaluation order of function arguments is unspecified, so the
+    /// slots may have been handed out in any order. Contents are moved so the
+    /// chain is submitted in the given order, `sqes` is updated to match.
+    template <std::size_t N>
+    void link(std::array<io_uring_sqe *, N> &sqes, uint8_t flag) {
+        std::array<io_uring_sqe, N> contents;
+        for (auto i = 0uz; i < N; ++i) {
+            contents[i] = *sqes[i];
+        }
+        auto slots = sqes;
+        std::ranges::sort(slots, {}, [this](const io_uring_sqe *sqe) { return position(sqe); });
+
+        // The SQ is submitted before the backlog moves in, which would split a
+        // chain starting at the end of the SQ. Move that part to the backlog.
+        auto num_in_sq = static_cast<std::size_t>(
+            std::ranges::count_if(slots, [this](const io_uring_sqe *sqe) { return in_sq(sqe); }));
+        if (num_in_sq > 0 && num_in_sq < N) [[unlikely]] {
+            for (auto i = num_in_sq; i-- > 0;) {
+                io_uring_prep_nop(slots[i]);
+                io_uring_sqe_set_data(slots[i], nullptr);
+                slots[i] = &backlog_.emplace_front();
+            }
+        }
+
+        for (auto i = 0uz; i < N; ++i) {
+            *slots[i] = contents[i];
+            if (i + 1 < N) {
+                slots[i]->flags |= flag;
+            }
+        }
+        sqes = slots;
     }
 
     [[nodiscard]]
-    auto peek_batch(std::span<io_uring_cqe *> cqes) -> std::size_t {
-        return io_uring_peek_batch_cqe(&ring_, cqes.data(), cqes.size());
+    auto has_backlog() const noexcept -> bool {
+        return !backlog_.empty();
+    }
+
+    /// Hand up to `max` ready cqes to `f` in completion order, then release
+    /// them to the kernel with a single head store. Returns the number reaped.
+    template <typename F>
+    auto reap(std::size_t max, F &&f) -> std::size_t {
+        // Walking the CQ never enters the kernel, pending task work and
+        // overflowed cqes only reach the CQ through a syscall
+        if (needs_flush()) {
+            if (auto ret = io_uring_get_events(&ring_); ret < 0) [[unlikely]] {
+                LOG_ERROR("io_uring_get_events failed, error: {}", strerror(-ret));
+            }
+        }
+        std::size_t   cnt{0};
+        unsigned      head;
+        io_uring_cqe *cqe;
+        io_uring_for_each_cqe(&ring_, head, cqe) {
+            if (cnt == max) {
+                break;
+            }
+            f(cqe);
+            cnt += 1;
+        }
+        io_uring_cq_advance(&ring_, static_cast<unsigned>(cnt));
+        return cnt;
     }
 
     [[nodiscard]]
@@ -53,12 +265,13 @@ public:
         return io_uring_peek_cqe(&ring_, cqe);
     }
 
-    void wait(std::optional<time_t> timeout) {
+    void wait(std::optional<std::chrono::nanoseconds> timeout) {
         io_uring_cqe *cqe{nullptr};
         if (timeout) {
             // LOG_DEBUG("wait for {}", timeout.value());
             struct __kernel_timespec ts {
-                .tv_sec = timeout.value() / 1000, .tv_nsec = timeout.value() % 1000 * 1000'000,
+                .tv_sec = timeout->count() / 1'000'000'000,
+                .tv_nsec = timeout->count() % 1'000'000'000,
             };
             if (auto ret = io_uring_wait_cqe_timeout(&ring_, &cqe, &ts); ret != 0 && ret != -ETIME)
                 [[unlikely]] {
@@ -79,24 +292,134 @@ public:
         io_uring_cqe_seen(&ring_, cqe);
     }
 
+    // Submit once enough sqes are queued, see `set_num_runnable`
     void submit() {
-        submit_tick_ += 1;
-        if (submit_tick_ == submit_interval_) {
+        count(stats_.num_requests_, 1);
+        if (io_uring_sq_ready(&ring_) >= submit_threshold_ || !backlog_.empty()) {
             force_submit();
         }
     }
 
     void force_submit() {
-        submit_tick_ = 0;
+        do_submit();
+        if (!backlog_.empty()) [[unlikely]] {
+            // The submit made room in the SQ
+            while (!backlog_.empty()) {
+                auto sqe = io_uring_get_sqe(&ring_);
+                if (sqe == nullptr) {
+                    break;
+                }
+                *sqe = backlog_.front();
+                backlog_.pop_front();
+            }
+            do_submit();
+        }
+    }
+
+    // Submit queued sqes before the worker goes looking for work or parks
+    void flush() {
+        if (io_uring_sq_ready(&ring_) > 0 || !backlog_.empty()) {
+            force_submit();
+        }
+    }
+
+    /// Adapt the submit batch to the number of tasks that are ready to run
+    /// after the current one. Each of them may queue another sqe, so batch up
+    /// to that many, capped by `submit_interval_` unless it is 0. With
+    /// nothing else runnable the sqe is submitted right away.
+    void set_num_runnable(std::size_t num_runnable) {
+        auto threshold = std::max(num_runnable, 1uz);
+        if (submit_interval_ > 0) {
+            threshold = std::min(threshold, static_cast<std::size_t>(submit_interval_));
+        }
+        submit_threshold_ = static_cast<uint32_t>(
+            std::min(threshold, static_cast<std::size_t>(std::numeric_limits<uint32_t>::max())));
+    }
+
+    /// Callable from any thread
+    [[nodiscard]]
+    auto stats() const noexcept -> SubmitStats {
+        return SubmitStats{
+            .num_requests_ = stats_.num_requests_.load(std::memory_order::relaxed),
+            .num_sqes_ = stats_.num_sqes_.load(std::memory_order::relaxed),
+            .num_syscalls_ = stats_.num_syscalls_.load(std::memory_order::relaxed),
+        };
+    }
+
+private:
+    [[nodiscard]]
+    auto needs_flush() const noexcept -> bool {
+        auto kflags = std::atomic_ref{*ring_.sq.kflags}.load(std::memory_order::relaxed);
+        return (kflags & (IORING_SQ_CQ_OVERFLOW | IORING_SQ_TASKRUN)) != 0;
+    }
+
+    [[nodiscard]]
+    auto in_sq(const io_uring_sqe *sqe) const noexcept -> bool {
+        std::less<const io_uring_sqe *> less;
+        return !less(sqe, ring_.sq.sqes) && less(sqe, ring_.sq.sqes + ring_.sq.ring_entries);
+    }
+
+    // Order in which an unsubmitted sqe will be submitted
+    [[nodiscard]]
+    auto position(const io_uring_sqe *sqe) const noexcept -> std::size_t {
+        if (in_sq(sqe)) {
+            auto index = static_cast<unsigned>(sqe - ring_.sq.sqes);
+            return (index - ring_.sq.sqe_head) & ring_.sq.ring_mask;
+        }
+        // Chains are built right after their sqes were handed out, look from the back
+        for (auto i = backlog_.size(); i-- > 0;) {
+            if (&backlog_[i] == sqe) {
+                return ring_.sq.ring_entries + i;
+            }
+        }
+        std::unreachable();
+    }
+
+    // When io_uring_submit enters the kernel: to submit sqes, which with
+    // SQPOLL only takes waking up its sleeping thread, or to reap with IOPOLL
+    // and to flush overflowed cqes or task work
+    [[nodiscard]]
+    auto submit_enters_kernel() const noexcept -> bool {
+        auto enters = io_uring_sq_ready(&ring_) > 0;
+        if (ring_.flags & IORING_SETUP_SQPOLL) {
+            auto kflags = std::atomic_ref{*ring_.sq.kflags}.load(std::memory_order::relaxed);
+            enters = enters && (kflags & IORING_SQ_NEED_WAKEUP) != 0;
+        }
+        return enters || (ring_.flags & IORING_SETUP_IOPOLL) != 0 || needs_flush();
+    }
+
+    void do_submit() {
+        if (submit_enters_kernel()) {
+            count(stats_.num_syscalls_, 1);
+        }
         if (auto ret = io_uring_submit(&ring_); ret < 0) [[unlikely]] {
             LOG_ERROR("submit sqes failed, {}", strerror(-ret));
+        } else {
+            count(stats_.num_sqes_, static_cast<std::size_t>(ret));
         }
     }
 
+    // Only the thread of the ring writes the counters, no read-modify-write needed
+    static void count(std::atomic<std::size_t> &counter, std::size_t n) noexcept {
+        counter.store(counter.load(std::memory_order::relaxed) + n, std::memory_order::relaxed);
+    }
+
+private:
+    struct Counters {
+        std::atomic<std::size_t> num_requests_{0};
+        std::atomic<std::size_t> num_sqes_{0};
+        std::atomic<std::size_t> num_syscalls_{0};
+    };
+
 private:
-    struct io_uring ring_ {};
-    uint32_t        submit_tick_{0};
-    uint32_t        submit_interval_;
+    struct io_uring             ring_ {};
+    uint32_t                    submit_threshold_{1};
+    uint32_t                    submit_interval_;
+    Counters                    stats_{};
+    // Sqes that did not fit into the SQ, deque keeps handed out pointers valid
+    std::deque<io_uring_sqe>    backlog_{};
+    std::unique_ptr<BufRing>    buf_ring_{};
+    std::shared_ptr<BufferPool> buffer_pool_{};
 };
 
 } // namespace zedio::runtime::detail
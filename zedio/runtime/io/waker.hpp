@@ -1,6 +1,8 @@
 #pragma once
 
 #include "zedio/runtime/io/io_uring.hpp"
+// C++
+#include <atomic>
 // Linux
 #include <sys/eventfd.h>
 #include <unistd.h>
@@ -22,13 +24,33 @@ public:
     }
 
 public:
+    // Only writes the eventfd if the owner is blocked in the ring, otherwise
+    // the owner observes the notification on its next `try_park`
     void wake_up() {
+        if (state_.exchange(NOTIFIED, std::memory_order::acq_rel) != PARKED) {
+            return;
+        }
         static constexpr uint64_t buf{1};
         if (auto ret = ::write(this->fd_, &buf, sizeof(buf)); ret != sizeof(buf)) [[unlikely]] {
             LOG_ERROR("Waker write failed, error: {}.", strerror(errno));
         }
     }
 
+    /// Returns `false` if a notification arrived, the owner must not block
+    [[nodiscard]]
+    auto try_park() -> bool {
+        auto expected = EMPTY;
+        return state_.compare_exchange_strong(expected,
+                                              PARKED,
+                                              std::memory_order::acq_rel,
+                                              std::memory_order::acquire);
+    }
+
+    // Consumes any pending notification
+    void unpark() {
+        state_.exchange(EMPTY, std::memory_order::acq_rel);
+    }
+
     void turn_on() {
         if (flag_ != 0) {
             flag_ = 0;
@@ -40,8 +62,14 @@ public:
     }
 
 private:
-    uint64_t flag_{1};
-    int      fd_;
+    static constexpr uint8_t EMPTY{0};
+    static constexpr uint8_t PARKED{1};
+    static constexpr uint8_t NOTIFIED{2};
+
+private:
+    uint64_t             flag_{1};
+    int                  fd_;
+    std::atomic<uint8_t> state_{EMPTY};
 };
 
 } // namespace zedio::runtime::detail
\ No newline at end of file
@@ -15,6 +15,8 @@ public:
             std::latch sync{2};
             auto       thread_name = build_thread_name_func(i);
             threads_.emplace_back([this, i, &thread_name, &sync]() {
+                shared_.bind_worker_thread(i);
+
                 Worker worker{shared_, i};
 
                 util::set_current_thread_name(thread_name);
@@ -51,6 +53,11 @@ public:
         }
     }
 
+    [[nodiscard]]
+    auto stats() -> detail::SubmitStats {
+        return shared_.submit_stats();
+    }
+
 public:
     Shared                   shared_;
     std::vector<std::thread> threads_{};
@@ -1,13 +1,12 @@
 #pragma once
 
 // C++
-#include <algorithm>
 #include <atomic>
+#include <bit>
 #include <limits>
-#include <list>
 #include <optional>
-#include <unordered_set>
 #include <utility>
+#include <vector>
 
 namespace zedio::runtime::multi_thread {
 
@@ -47,6 +46,35 @@ public:
         state_.fetch_add(num_searching | (1 << WORKING_SHIFT), std::memory_order::seq_cst);
     }
 
+    /// Reserves a sleeping worker as a new searching worker if no worker is
+    /// searching and not all workers are working
+    [[nodiscard]]
+    auto try_wake_up_one(std::size_t num_workers) -> bool {
+        auto state = state_.load(std::memory_order::seq_cst);
+        while (true) {
+            if ((state & SEARCHING_MASK) != 0
+                || ((state & WORKING_MASK) >> WORKING_SHIFT) >= num_workers) {
+                return false;
+            }
+            if (state_.compare_exchange_weak(state,
+                                             state + (1 | (1 << WORKING_SHIFT)),
+                                             std::memory_order::seq_cst,
+                                             std::memory_order::seq_cst)) {
+                return true;
+            }
+        }
+    }
+
+    /// Undo a `wake_up_one(0)`
+    void cancel_wake_up_one() {
+        state_.fetch_sub(1 << WORKING_SHIFT, std::memory_order::seq_cst);
+    }
+
+    /// Undo a successful `try_wake_up_one` or a `wake_up_one(1)`
+    void cancel_try_wake_up_one() {
+        state_.fetch_sub(1 | (1 << WORKING_SHIFT), std::memory_order::seq_cst);
+    }
+
     /// Returns `true` if this is the final searching worker.
     [[nodiscard]]
     auto dec_num_working(bool is_searching) -> bool {
@@ -75,37 +103,76 @@ private:
     std::atomic<std::size_t> state_;
 };
 
+/// Sleeping workers are tracked in a bitmap, one bit per worker.
+///
+/// A bit is always set before the working count is decremented and the
+/// working count is always incremented before a bit is cleared, so the
+/// number of set bits never falls below the number of non-working workers
+/// that have not been claimed yet. A notifier that reserves a worker in
+/// `IdleState` still races with the worker removing its own bit, if a scan
+/// finds nothing it gives the reservation back instead of waiting.
 class Idle {
+    static constexpr std::size_t BITS_PER_WORD{64};
 
 public:
     Idle(std::size_t num_workers)
         : state_{num_workers}
-        , num_workers_{num_workers} {}
+        , num_workers_{num_workers}
+        , sleepers_((num_workers + BITS_PER_WORD - 1) / BITS_PER_WORD) {}
 
     [[nodiscard]]
     auto worker_to_notify() -> std::optional<std::size_t> {
-        if (!notify_should_wakeup()) {
+        if (!state_.try_wake_up_one(num_workers_)) {
             return std::nullopt;
         }
-
-        std::lock_guard lock(mutex_);
-
-        if (!notify_should_wakeup()) {
-            return std::nullopt;
+        for (auto i = 0uz; i < sleepers_.size(); ++i) {
+            auto word = sleepers_[i].load(std::memory_order::acquire);
+            while (word != 0) {
+                auto bit = static_cast<std::size_t>(std::countr_zero(word));
+                auto mask = uint64_t{1} << bit;
+                word = sleepers_[i].fetch_and(~mask, std::memory_order::acq_rel);
+                if (word & mask) {
+                    return i * BITS_PER_WORD + bit;
+                }
+            }
         }
+        // The reserved sleeper woke up by itself and removed its bit, it is
+        // running now and will find the work
+        state_.cancel_try_wake_up_one();
+        return std::nullopt;
+    }
 
+    /// Claim a sleeping worker to hand a task to, scanning from `hint`. Unlike
+    /// `worker_to_notify` it does not wait for the searching workers, the
+    /// claimed worker is counted as searching all the same.
+    [[nodiscard]]
+    auto claim_sleeper(std::size_t hint) -> std::optional<std::size_t> {
+        // Count it as working before its bit is cleared, like `remove`
         state_.wake_up_one(1);
-        auto result = *sleeping_workers.begin();
-        sleeping_workers.erase(result);
-        return result;
+        auto first = hint / BITS_PER_WORD % sleepers_.size();
+        auto shift = static_cast<int>(hint % BITS_PER_WORD);
+        for (auto i = 0uz; i < sleepers_.size(); ++i) {
+            auto index = (first + i) % sleepers_.size();
+            auto word = sleepers_[index].load(std::memory_order::acquire);
+            while (word != 0) {
+                auto zeros = static_cast<std::size_t>(std::countr_zero(std::rotr(word, shift)));
+                auto bit = (zeros + hint) % BITS_PER_WORD;
+                auto mask = uint64_t{1} << bit;
+                word = sleepers_[index].fetch_and(~mask, std::memory_order::acq_rel);
+                if (word & mask) {
+                    return index * BITS_PER_WORD + bit;
+                }
+            }
+        }
+        state_.cancel_try_wake_up_one();
+        return std::nullopt;
     }
 
     [[nodiscard]]
     auto transition_worker_to_sleeping(std::size_t worker, bool is_searching) -> bool {
-        std::lock_guard lock(mutex_);
-        auto            result = state_.dec_num_working(is_searching);
-        sleeping_workers.emplace(worker);
-        return result;
+        auto [index, mask] = locate(worker);
+        sleepers_[index].fetch_or(mask, std::memory_order::release);
+        return state_.dec_num_working(is_searching);
     }
 
     [[nodiscard]]
@@ -125,33 +192,35 @@ public:
     /// Returns `true` if the worker was sleeped before calling the method.
     [[nodiscard]]
     auto remove(std::size_t worker) -> bool {
-        std::lock_guard lock(mutex_);
-        if (sleeping_workers.erase(worker) > 0) {
-            state_.wake_up_one(0);
+        auto [index, mask] = locate(worker);
+        if (!(sleepers_[index].load(std::memory_order::acquire) & mask)) {
+            return false;
+        }
+        state_.wake_up_one(0);
+        if (sleepers_[index].fetch_and(~mask, std::memory_order::acq_rel) & mask) {
             return true;
         }
+        // A notifier claimed the worker first and counted it as working
+        state_.cancel_wake_up_one();
         return false;
     }
 
     [[nodiscard]]
     auto contains(std::size_t worker) -> bool {
-        std::lock_guard lock(mutex_);
-        return sleeping_workers.find(worker) != sleeping_workers.end();
+        auto [index, mask] = locate(worker);
+        return (sleepers_[index].load(std::memory_order::acquire) & mask) != 0;
     }
 
 private:
     [[nodiscard]]
-    auto notify_should_wakeup() -> bool {
-        auto [num_working, num_searching]
-            = state_.num_working_and_searching(std::memory_order::seq_cst);
-        return num_searching == 0 && num_working < num_workers_;
+    static auto locate(std::size_t worker) -> std::pair<std::size_t, uint64_t> {
+        return {worker / BITS_PER_WORD, uint64_t{1} << (worker % BITS_PER_WORD)};
     }
 
 private:
-    IdleState                       state_;
-    std::size_t                     num_workers_;
-    std::unordered_set<std::size_t> sleeping_workers;
-    std::mutex                      mutex_;
+    IdleState                          state_;
+    std::size_t                        num_workers_;
+    std::vector<std::atomic<uint64_t>> sleepers_;
 };
 
 } // namespace zedio::runtime::multi_thread
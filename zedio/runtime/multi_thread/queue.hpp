@@ -1,110 +1,242 @@
 #pragma once
 
 #include "zedio/common/debug.hpp"
+#include "zedio/common/util/thread.hpp"
 #include "zedio/runtime/config.hpp"
 
 // C
 #include <cassert>
 // C++
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
 #include <coroutine>
+#include <deque>
 #include <expected>
 #include <format>
-#include <list>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <utility>
 
 namespace zedio::runtime::multi_thread {
 
+/// Bounded MPMC ring of tasks with a locked spill list behind it. Producers
+/// and consumers reserve slots with one CAS, then wait for the slot itself,
+/// so it is not lock-free: a thread preempted between reserving and
+/// publishing a slot blocks those reaching the slot after it. Once tasks
+/// spill, producers keep spilling and consumers move the spilled tasks back
+/// into the ring, so tasks come out in the order they were pushed.
 class GlobalQueue {
+    struct Slot {
+        std::atomic<std::size_t> sequence_;
+        std::coroutine_handle<>  task_;
+    };
+
+public:
+    explicit GlobalQueue(std::size_t capacity = detail::GLOBAL_QUEUE_CAPACITY)
+        : slots_{std::make_unique<Slot[]>(capacity)}
+        , mask_{capacity - 1} {
+        assert(std::has_single_bit(capacity));
+        for (auto i = 0uz; i < capacity; i += 1) {
+            slots_[i].sequence_.store(i, std::memory_order::relaxed);
+        }
+    }
+
 public:
     [[nodiscard]]
     auto size() -> std::size_t {
-        return num_.load(std::memory_order::acquire);
+        // Load head before tail, tail is never behind head
+        auto head = head_.load(std::memory_order::acquire);
+        auto tail = tail_.load(std::memory_order::acquire);
+        return tail - head + num_spilled_.load(std::memory_order::acquire);
     }
 
     [[nodiscard]]
     auto empty() -> bool {
-        return num_ == 0;
+        return size() == 0;
+    }
+
+    [[nodiscard]]
+    auto capacity() const noexcept -> std::size_t {
+        return mask_ + 1;
     }
 
     void push(std::coroutine_handle<> task) {
-        std::lock_guard lock(mutex_);
-        if (is_closed_) [[unlikely]] {
-            return;
-        }
-        tasks_.push_back(task);
-        num_.fetch_add(1, std::memory_order::seq_cst);
+        push_batch(std::span{&task, 1}, 1);
     }
 
-    void push_batch(std::list<std::coroutine_handle<>> &&tasks, std::size_t n) {
-        std::lock_guard lock(mutex_);
-        if (is_closed_) [[unlikely]] {
+    template <class C>
+    void push_batch(const C &tasks, std::size_t n) {
+        if (is_closed_.load(std::memory_order::acquire)) [[unlikely]] {
+            return;
+        }
+        // Stay behind the spilled tasks
+        if (num_spilled_.load(std::memory_order::acquire) > 0) [[unlikely]] {
+            spill(tasks, n);
             return;
         }
-        tasks_.splice(tasks_.end(), tasks);
-        num_.fetch_add(n, std::memory_order::seq_cst);
+        std::size_t tail{0};
+        while (true) {
+            auto head = head_.load(std::memory_order::acquire);
+            tail = tail_.load(std::memory_order::acquire);
+            if (tail - head + n > capacity()) [[unlikely]] {
+                spill(tasks, n);
+                return;
+            }
+            if (tail_.compare_exchange_weak(tail,
+                                            tail + n,
+                                            std::memory_order::acq_rel,
+                                            std::memory_order::relaxed)) {
+                break;
+            }
+        }
+        publish(tail, std::begin(tasks), n);
     }
 
     [[nodiscard]]
     auto pop() -> std::optional<std::coroutine_handle<>> {
-        std::lock_guard lock(mutex_);
-        if (tasks_.empty()) {
-            return std::nullopt;
-        }
-        auto result = std::move(tasks_.front());
-        tasks_.pop_front();
-        num_.fetch_sub(1, std::memory_order::release);
+        std::optional<std::coroutine_handle<>> result{std::nullopt};
+        pop_with(1, [&result](std::coroutine_handle<> task) { result.emplace(task); });
         return result;
     }
 
+    // Returns the number of tasks actually written into `tasks`
     [[nodiscard]]
-    auto pop_n(std::size_t &n) -> std::list<std::coroutine_handle<>> {
-        std::lock_guard lock(mutex_);
-
-        n = std::min(num_.load(std::memory_order::relaxed), n);
-        num_.fetch_sub(n, std::memory_order::release);
-
-        std::list<std::coroutine_handle<>> result;
-
-        auto end = tasks_.begin();
-        std::advance(end, n);
-        result.splice(result.end(), tasks_, tasks_.begin(), end);
-        return result;
+    auto pop_n(std::span<std::coroutine_handle<>> tasks) -> std::size_t {
+        auto it = tasks.begin();
+        return pop_with(tasks.size(), [&it](std::coroutine_handle<> task) { *it++ = task; });
     }
 
     [[nodiscard]]
     auto close() -> bool {
-        std::lock_guard lock{mutex_};
-        if (is_closed_) {
-            return false;
-        }
-        is_closed_ = true;
-        return true;
+        return !is_closed_.exchange(true, std::memory_order::acq_rel);
     }
 
     [[nodiscard]]
     auto is_closed() -> bool {
-        std::lock_guard lock{mutex_};
-        return is_closed_;
+        return is_closed_.load(std::memory_order::acquire);
     }
 
 private:
-    std::list<std::coroutine_handle<>> tasks_{};
-    std::atomic<std::size_t>           num_{0};
-    std::mutex                         mutex_{};
-    bool                               is_closed_{false};
+    template <typename F>
+    auto pop_with(std::size_t n, F &&f) -> std::size_t {
+        std::size_t head{0};
+        std::size_t cnt{0};
+        while (true) {
+            head = head_.load(std::memory_order::acquire);
+            auto tail = tail_.load(std::memory_order::acquire);
+            cnt = std::min(tail - head, n);
+            if (cnt == 0) {
+                break;
+            }
+            if (head_.compare_exchange_weak(head,
+                                            head + cnt,
+                                            std::memory_order::acq_rel,
+                                            std::memory_order::relaxed)) {
+                break;
+            }
+        }
+        // Slots [head, head + cnt) are reserved, wait for their producers to finish
+        for (auto i = 0uz; i < cnt; i += 1) {
+            auto &slot = slots_[(head + i) & mask_];
+            while (slot.sequence_.load(std::memory_order::acquire) != head + i + 1) {
+                util::spin_loop_hint();
+            }
+            f(slot.task_);
+            slot.sequence_.store(head + i + capacity(), std::memory_order::release);
+        }
+        if (cnt < n && num_spilled_.load(std::memory_order::acquire) > 0) [[unlikely]] {
+            std::lock_guard lock{spilled_mutex_};
+            while (cnt < n && !spilled_.empty()) {
+                f(spilled_.front());
+                spilled_.pop_front();
+                cnt += 1;
+                num_spilled_.fetch_sub(1, std::memory_order::release);
+            }
+            refill();
+        }
+        return cnt;
+    }
+
+    // Slots [tail, tail + n) are reserved, wait for the consumers of the previous round
+    template <class It>
+    void publish(std::size_t tail, It it, std::size_t n) {
+        for (auto i = 0uz; i < n; i += 1, ++it) {
+            auto &slot = slots_[(tail + i) & mask_];
+            while (slot.sequence_.load(std::memory_order::acquire) != tail + i) {
+                util::spin_loop_hint();
+            }
+            slot.task_ = *it;
+            slot.sequence_.store(tail + i + 1, std::memory_order::release);
+        }
+    }
+
+    // Move the oldest spilled tasks into the free part of the ring, so the
+    // following pops take no lock. Call with `spilled_mutex_` held.
+    void refill() {
+        while (!spilled_.empty()) {
+            auto head = head_.load(std::memory_order::acquire);
+            auto tail = tail_.load(std::memory_order::acquire);
+            auto n = std::min(capacity() - (tail - head), spilled_.size());
+            if (n == 0) {
+                return;
+            }
+            if (tail_.compare_exchange_weak(tail,
+                                            tail + n,
+                                            std::memory_order::acq_rel,
+                                            std::memory_order::relaxed)) {
+                publish(tail, spilled_.begin(), n);
+                spilled_.erase(spilled_.begin(), spilled_.begin() + static_cast<std::ptrdiff_t>(n));
+                num_spilled_.fetch_sub(n, std::memory_order::release);
+                return;
+            }
+        }
+    }
+
+    // Slow path, only used when the ring is full
+    template <class C>
+    void spill(const C &tasks, std::size_t n) {
+        std::lock_guard lock{spilled_mutex_};
+        auto            it = std::begin(tasks);
+        for (auto i = 0uz; i < n; i += 1, ++it) {
+            spilled_.push_back(*it);
+        }
+        num_spilled_.fetch_add(n, std::memory_order::release);
+    }
+
+private:
+    std::unique_ptr<Slot[]>              slots_;
+    std::size_t                          mask_;
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::atomic<std::size_t> num_spilled_{0};
+    std::atomic<bool>                    is_closed_{false};
+    std::deque<std::coroutine_handle<>>  spilled_{};
+    std::mutex                           spilled_mutex_{};
 };
 
 class LocalQueue {
+public:
+    // capacity must be a power of two
+    explicit LocalQueue(std::size_t capacity = detail::LOCAL_QUEUE_CAPACITY)
+        : mask_{capacity - 1}
+        , buffer_{std::make_unique<std::coroutine_handle<>[]>(capacity)}
+        , overflow_batch_{std::make_unique<std::coroutine_handle<>[]>(capacity / 2 + 1)} {
+        assert(std::has_single_bit(capacity) && capacity >= 2);
+        assert(capacity <= std::numeric_limits<uint32_t>::max() / 2);
+    }
+
 public:
     [[nodiscard]]
     auto remaining_slots() -> std::size_t {
         auto [steal, _] = unpack(head_.load(std::memory_order::acquire));
         auto tail = tail_.load(std::memory_order::acquire);
-        assert(detail::LOCAL_QUEUE_CAPACITY >= static_cast<std::size_t>(tail - steal));
-        return detail::LOCAL_QUEUE_CAPACITY - static_cast<std::size_t>(tail - steal);
+        assert(capacity() >= static_cast<std::size_t>(tail - steal));
+        return capacity() - static_cast<std::size_t>(tail - steal);
     }
 
     [[nodiscard]]
@@ -120,13 +252,13 @@ public:
     }
 
     [[nodiscard]]
-    constexpr auto capacity() const noexcept -> std::size_t {
-        return buffer_.max_size();
+    auto capacity() const noexcept -> std::size_t {
+        return mask_ + 1;
     }
 
     // Caller must ensure that there is no overflow before calling the method
-    template <class C>
-    void push_batch(const C &tasks, std::size_t len) {
+    void push_batch(std::span<const std::coroutine_handle<>> tasks) {
+        auto len = tasks.size();
         assert(0 < len && len <= capacity());
 
         auto [steal, _] = unpack(head_.load(std::memory_order::acquire));
@@ -138,9 +270,9 @@ public:
                                                  capacity() - len));
         }
 
-        for (auto &&task : tasks) {
-            std::size_t idx = tail & MASK;
-            buffer_[idx] = std::move(task);
+        for (auto task : tasks) {
+            std::size_t idx = tail & mask_;
+            buffer_[idx] = task;
             tail += 1;
         }
 
@@ -154,7 +286,7 @@ public:
             auto head = head_.load(std::memory_order::acquire);
             auto [steal, real] = unpack(head);
             tail = tail_.load(std::memory_order::relaxed);
-            if (tail - steal < static_cast<uint32_t>(detail::LOCAL_QUEUE_CAPACITY)) {
+            if (tail - steal < static_cast<uint32_t>(capacity())) {
                 // There is capacity for the task
                 break;
             } else if (steal != real) {
@@ -169,7 +301,7 @@ public:
                 }
             }
         }
-        std::size_t idx = static_cast<std::size_t>(tail) & MASK;
+        std::size_t idx = static_cast<std::size_t>(tail) & mask_;
         buffer_[idx] = std::move(task);
         tail_.store(tail + 1, std::memory_order::release);
     }
@@ -191,7 +323,7 @@ public:
                                             next,
                                             std::memory_order::acq_rel,
                                             std::memory_order::acquire)) {
-                idx = static_cast<std::size_t>(real) & MASK;
+                idx = static_cast<std::size_t>(real) & mask_;
                 break;
             }
         }
@@ -207,7 +339,7 @@ public:
         auto dst_tail = dst.tail_.load(std::memory_order::relaxed);
 
         // less than half of local_queue_capacity just return
-        if (dst_tail - steal > static_cast<uint32_t>(detail::LOCAL_QUEUE_CAPACITY / 2)) {
+        if (dst_tail - steal > static_cast<uint32_t>(dst.capacity() / 2)) {
             return result;
         }
         auto n = steal_into2(dst, dst_tail);
@@ -218,7 +350,7 @@ public:
         /// Take the final task for result
         n -= 1;
         auto        dst_new_tail = dst_tail + n;
-        std::size_t idx = static_cast<std::size_t>(dst_new_tail) & MASK;
+        std::size_t idx = static_cast<std::size_t>(dst_new_tail) & dst.mask_;
         result.emplace(std::move(dst.buffer_[idx]));
         if (n > 0) {
             dst.tail_.store(dst_new_tail, std::memory_order::release);
@@ -242,7 +374,8 @@ private:
             }
 
             n = src_tail - src_real;
-            n = n - n / 2;
+            // Never take more than dst has room for, queues may differ in capacity
+            n = std::min(n - n / 2, static_cast<uint32_t>(dst.capacity() / 2));
             if (n == 0) {
                 return 0;
             }
@@ -259,8 +392,8 @@ private:
         }
         auto [first, _] = unpack(next_packed);
         for (uint32_t i = 0; i < n; ++i) {
-            auto src_idx = static_cast<std::size_t>(first + i) & MASK;
-            auto dst_idx = static_cast<std::size_t>(dst_tail + i) & MASK;
+            auto src_idx = static_cast<std::size_t>(first + i) & mask_;
+            auto dst_idx = static_cast<std::size_t>(dst_tail + i) & dst.mask_;
             dst.buffer_[dst_idx] = std::move(buffer_[src_idx]);
         }
 
@@ -282,10 +415,9 @@ private:
                        uint32_t                  head,
                        [[maybe_unused]] uint32_t tail,
                        GlobalQueue              &global_queue) -> bool {
-        static constexpr auto NUM_TASKS_TAKEN{
-            static_cast<uint32_t>(detail::LOCAL_QUEUE_CAPACITY / 2)};
+        const auto NUM_TASKS_TAKEN{static_cast<uint32_t>(capacity() / 2)};
 
-        assert(tail - head == detail::LOCAL_QUEUE_CAPACITY);
+        assert(tail - head == capacity());
 
         auto prev = pack(head, head);
 
@@ -296,19 +428,18 @@ private:
             return false;
         }
 
-        std::list<std::coroutine_handle<>> tasks;
+        // Move the taken half and the new task to the global queue in one block
+        auto tasks = std::span{overflow_batch_.get(), NUM_TASKS_TAKEN + 1uz};
         for (uint32_t i = 0; i < NUM_TASKS_TAKEN; ++i) {
-            std::size_t idx = static_cast<std::size_t>(head + i) & MASK;
-            tasks.push_back(std::move(buffer_[idx]));
+            std::size_t idx = static_cast<std::size_t>(head + i) & mask_;
+            tasks[i] = buffer_[idx];
         }
-        tasks.push_back(std::move(task));
-        global_queue.push_batch(std::move(tasks), NUM_TASKS_TAKEN + 1);
+        tasks[NUM_TASKS_TAKEN] = task;
+        global_queue.push_batch(tasks, tasks.size());
         return true;
     }
 
 private:
-    static constexpr std::size_t MASK = detail::LOCAL_QUEUE_CAPACITY - 1;
-
     // [[nodiscard]]
     // static auto wrapping_add(uint32_t a, uint32_t b) -> uint32_t {
     //     return a + b;
@@ -330,9 +461,12 @@ private:
     }
 
 private:
-    std::atomic<uint64_t> head_{0};
-    std::atomic<uint32_t> tail_{0};
-    std::array<std::coroutine_handle<>, detail::LOCAL_QUEUE_CAPACITY> buffer_;
+    std::atomic<uint64_t>                      head_{0};
+    std::atomic<uint32_t>                      tail_{0};
+    std::size_t                                mask_;
+    std::unique_ptr<std::coroutine_handle<>[]> buffer_;
+    // Only touched by the owner when half of the queue overflows
+    std::unique_ptr<std::coroutine_handle<>[]> overflow_batch_;
 };
 
 } // namespace zedio::runtime::multi_thread
@@ -1,14 +1,26 @@
 #pragma once
 
 #include "zedio/common/debug.hpp"
+#include "zedio/common/util/thread.hpp"
+#include "zedio/common/util/topology.hpp"
 #include "zedio/runtime/config.hpp"
+#include "zedio/runtime/io/io_uring.hpp"
 #include "zedio/runtime/multi_thread/idle.hpp"
 #include "zedio/runtime/multi_thread/queue.hpp"
 // C++
+#include <algorithm>
 #include <latch>
+#include <list>
+#include <mutex>
 #include <thread>
 #include <vector>
 
+namespace zedio::runtime::detail {
+
+class Driver;
+
+} // namespace zedio::runtime::detail
+
 namespace zedio::runtime::multi_thread {
 
 class Worker;
@@ -23,7 +35,19 @@ public:
     Shared(detail::Config config)
         : config_{config}
         , idle_{config.num_workers_}
-        , shutdown_{static_cast<std::ptrdiff_t>(config.num_workers_)} {
+        , shutdown_{static_cast<std::ptrdiff_t>(config.num_workers_)}
+        , drivers_(config.num_workers_, nullptr) {
+        // Workers start stealing while later ones are still being built
+        workers_.reserve(config.num_workers_);
+        if (config.topology_aware_ || config.pin_workers_) {
+            auto cpus = util::cpu_topology();
+            if (!config.cpu_affinity_.empty()) {
+                cpus = select_cpus(cpus, config.cpu_affinity_);
+            }
+            for (auto i = 0uz; i < config.num_workers_ && !cpus.empty(); ++i) {
+                worker_cpus_.push_back(cpus[i % cpus.size()]);
+            }
+        }
         assert(t_shared == nullptr);
         t_shared = this;
     }
@@ -33,6 +57,21 @@ public:
     }
 
 public:
+    // Called on the thread of worker `index` before the worker, and so its
+    // ring, is built
+    void bind_worker_thread(std::size_t index) {
+        if (!worker_cpus_.empty()) {
+            auto cpu = worker_cpus_[index].cpu_;
+            if (!util::set_current_thread_affinity(cpu)) {
+                LOG_WARN("Failed to pin worker {} to cpu {}", index, cpu);
+            }
+        } else if (!config_.cpu_affinity_.empty()) {
+            if (!util::set_current_thread_affinity(config_.cpu_affinity_)) {
+                LOG_WARN("Failed to set the cpu affinity of worker {}", index);
+            }
+        }
+    }
+
     void wake_up_one();
 
     void wake_up_all();
@@ -53,10 +92,11 @@ public:
         }
     }
 
-    void schedule_remote(std::coroutine_handle<> handle) {
-        global_queue_.push(handle);
-        wake_up_one();
-    }
+    void schedule_remote(std::coroutine_handle<> handle);
+
+    // Summed over the rings of all workers, finished ones included
+    [[nodiscard]]
+    auto submit_stats() -> detail::SubmitStats;
 
     void schedule_remote_batch(std::list<std::coroutine_handle<>> &&handles, std::size_t n) {
         global_queue_.push_batch(std::move(handles), n);
@@ -64,11 +104,38 @@ public:
     }
 
 private:
-    const detail::Config  config_;
-    Idle                  idle_;
-    GlobalQueue           global_queue_{};
-    std::latch            shutdown_;
-    std::vector<Worker *> workers_{};
+    // Keep the order given by the user, cpus unknown to sysfs get their own cache
+    [[nodiscard]]
+    static auto select_cpus(const std::vector<util::CpuInfo> &topology,
+                            const std::vector<int>           &cpus) -> std::vector<util::CpuInfo> {
+        std::vector<util::CpuInfo> result;
+        for (auto cpu : cpus) {
+            auto it = std::find_if(topology.begin(), topology.end(), [cpu](const auto &info) {
+                return info.cpu_ == cpu;
+            });
+            if (it != topology.end()) {
+                result.push_back(*it);
+            } else {
+                result.push_back(util::CpuInfo{.cpu_ = cpu, .node_ = 0, .llc_ = cpu});
+            }
+        }
+        return result;
+    }
+
+private:
+    const detail::Config                config_;
+    Idle                                idle_;
+    GlobalQueue                         global_queue_{};
+    std::latch                          shutdown_;
+    std::vector<Worker *>               workers_{};
+    // Cpu of each worker, empty if workers are not pinned
+    std::vector<util::CpuInfo>          worker_cpus_{};
+    // Guards `drivers_` and `retired_stats_`
+    std::mutex                          stats_mutex_{};
+    // Drivers of the running workers, a worker clears its own when it stops
+    std::vector<const detail::Driver *> drivers_;
+    // Submit stats of the stopped workers
+    detail::SubmitStats                 retired_stats_{};
 };
 
 } // namespace zedio::runtime::multi_thread
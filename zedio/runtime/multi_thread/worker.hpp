@@ -5,6 +5,9 @@
 #include "zedio/common/util/thread.hpp"
 #include "zedio/runtime/driver.hpp"
 #include "zedio/runtime/multi_thread/shared.hpp"
+// C++
+#include <span>
+#include <vector>
 
 namespace zedio::runtime::multi_thread {
 
@@ -19,21 +22,36 @@ public:
     Worker(Shared &shared, std::size_t index)
         : shared_{shared}
         , index_{index}
-        , driver_{shared.config_} {
+        // Later rings share the SQPOLL thread of the first one
+        , driver_{shared.config_,
+                  shared.workers_.empty() ? -1 : shared.workers_.front()->driver_.ring_fd()}
+        , local_queue_{shared.config_.local_queue_capacity_}
+        , global_batch_(shared.config_.local_queue_capacity_ / 2) {
         shared_.workers_.push_back(this);
 
         assert(shared_.workers_.size() == index + 1);
         assert(shared_.workers_.back() == this);
+        {
+            std::lock_guard lock{shared_.stats_mutex_};
+            shared_.drivers_[index] = &driver_;
+        }
 
         assert(t_worker == nullptr);
         t_worker = this;
         assert(t_shared == nullptr);
         t_shared = std::addressof(shared);
 
+        build_steal_order();
+
         LOG_TRACE("Build {}", util::get_current_thread_name());
     }
 
     ~Worker() {
+        {
+            std::lock_guard lock{shared_.stats_mutex_};
+            shared_.retired_stats_ += driver_.stats();
+            shared_.drivers_[index_] = nullptr;
+        }
         t_worker = nullptr;
         t_shared = nullptr;
         shared_.shutdown_.arrive_and_wait();
@@ -52,6 +70,9 @@ public:
                 continue;
             }
 
+            // Nothing runnable, don't let queued sqes wait for other workers
+            driver_.flush();
+
             // step 2: try to steal work from other worker
             if (auto task = steal_work(); task) {
                 execute_task(std::move(task.value()));
@@ -75,17 +96,52 @@ public:
 
     void schedule_local(std::coroutine_handle<> task) {
         if (run_next_.has_value()) {
-            local_queue_.push_back_or_overflow(std::move(run_next_.value()), shared_.global_queue_);
+            if (!hand_off(run_next_.value())) {
+                local_queue_.push_back_or_overflow(std::move(run_next_.value()),
+                                                   shared_.global_queue_);
+                shared_.wake_up_one();
+            }
             run_next_.emplace(std::move(task));
-            shared_.wake_up_one();
         } else {
             run_next_.emplace(std::move(task));
         }
     }
 
+    /// Post `task` into the ring of a sleeping worker, the completion wakes it
+    /// up. The worker is claimed in `Idle` first, so no other source picks it
+    /// and it wakes up searching as if it had been notified.
+    [[nodiscard]]
+    auto hand_off(std::coroutine_handle<> task) -> bool {
+        if (!shared_.config_.msg_ring_ || !detail::Driver::can_post_task(task)) {
+            return false;
+        }
+        auto num = static_cast<uint32_t>(shared_.workers_.size());
+        auto index = shared_.idle_.claim_sleeper(rand_.fastrand_n(num));
+        if (!index) {
+            return false;
+        }
+        // A running worker is never in the sleeper set
+        assert(index.value() != index_);
+        LOG_TRACE("Hand off a task to ZEDIO_WORKER_{}", index.value());
+        driver_.post_task(shared_.workers_[index.value()]->driver_.ring_fd(), index.value(), task);
+        return true;
+    }
+
+    /// A failed hand-off brings the task back to this worker, the claimed
+    /// worker is still asleep with its claim counted, wake it up as if it had
+    /// been notified
+    void wake_up_failed_hand_offs() {
+        for (auto index : driver_.take_failed_posts()) {
+            LOG_TRACE("Hand-off to ZEDIO_WORKER_{} failed, wake it up", index);
+            shared_.workers_[index]->wake_up();
+        }
+    }
+
 private:
     void execute_task(std::coroutine_handle<> &&task) {
         this->transition_from_searching();
+        driver_.set_num_runnable(static_cast<std::size_t>(run_next_.has_value())
+                                 + local_queue_.size());
         task.resume();
     }
 
@@ -166,23 +222,60 @@ private:
         if (!transition_to_searching()) {
             return std::nullopt;
         }
-        auto num = shared_.workers_.size();
-        // auto start = rand() % num;
-        auto start = static_cast<std::size_t>(rand_.fastrand_n(static_cast<uint32_t>(num)));
-        for (std::size_t i = 0; i < num; ++i) {
-            auto idx = (start + i) % num;
-            if (idx == index_) {
-                continue;
-            }
-            if (auto result = shared_.workers_[idx]->local_queue_.steal_into(local_queue_);
-                result) {
-                return result;
+        // Visit each group of siblings from a random start
+        auto begin = 0uz;
+        for (auto end : steal_group_ends_) {
+            auto num = end - begin;
+            auto start = static_cast<std::size_t>(rand_.fastrand_n(static_cast<uint32_t>(num)));
+            for (std::size_t i = 0; i < num; ++i) {
+                auto idx = steal_order_[begin + (start + i) % num];
+                // Later workers may not be built yet
+                if (idx >= shared_.workers_.size()) {
+                    continue;
+                }
+                if (auto result = shared_.workers_[idx]->local_queue_.steal_into(local_queue_);
+                    result) {
+                    return result;
+                }
             }
+            begin = end;
         }
         // Final check the global queue again
         return shared_.next_global_task();
     }
 
+    // Order the other workers by distance: same last level cache, same NUMA
+    // node, then the rest. Without topology all of them form one group.
+    void build_steal_order() {
+        const auto &cpus = shared_.worker_cpus_;
+        auto        num = shared_.config_.num_workers_;
+        if (!shared_.config_.topology_aware_ || cpus.empty()) {
+            for (auto i = 0uz; i < num; ++i) {
+                if (i != index_) {
+                    steal_order_.push_back(i);
+                }
+            }
+            steal_group_ends_.push_back(steal_order_.size());
+            return;
+        }
+
+        const auto &self = cpus[index_];
+        auto        distance = [&self](const util::CpuInfo &other) {
+            if (other.node_ != self.node_) {
+                return 2;
+            }
+            return other.llc_ == self.llc_ ? 0 : 1;
+        };
+        for (auto d = 0; d < 3; ++d) {
+            for (auto i = 0uz; i < num; ++i) {
+                if (i != index_ && distance(cpus[i]) == d) {
+                    steal_order_.push_back(i);
+                }
+            }
+            steal_group_ends_.push_back(steal_order_.size());
+        }
+    }
+
     /// If need, nonblocking poll I/O events and check if the scheduler has been shutdown
     void maintenance() {
         if (this->tick_ % shared_.config_.io_interval_ == 0) {
@@ -220,16 +313,16 @@ private:
             }
             // We need pull 1/num_workers part of tasks
             n = std::min(shared_.global_queue_.size() / shared_.workers_.size() + 1, n);
-            // n will be set to the number of tasks that are actually fetched
-            auto tasks = shared_.global_queue_.pop_n(n);
+
+            auto tasks = std::span{global_batch_};
+            // n is set to the number of tasks that are actually fetched
+            n = shared_.global_queue_.pop_n(tasks.first(n));
             if (n == 0) {
                 return std::nullopt;
             }
-            auto result = std::move(tasks.front());
-            tasks.pop_front();
-            n -= 1;
-            if (n > 0) {
-                local_queue_.push_batch(tasks, n);
+            auto result = tasks[0];
+            if (n > 1) {
+                local_queue_.push_batch(tasks.subspan(1, n - 1));
             }
             return result;
         }
@@ -251,7 +344,9 @@ private:
     // poll I/O events
     [[nodiscard]]
     auto poll() -> bool {
-        if (!driver_.poll(local_queue_, shared_.global_queue_)) {
+        auto has_events = driver_.poll(local_queue_, shared_.global_queue_);
+        wake_up_failed_hand_offs();
+        if (!has_events) {
             return false;
         }
         if (should_notify_others()) {
@@ -266,6 +361,7 @@ private:
         if (transition_to_sleeping()) {
             while (!is_shutdown_) {
                 driver_.wait(local_queue_, shared_.global_queue_);
+                wake_up_failed_hand_offs();
                 LOG_TRACE("sleep, tick {}", tick_);
                 check_shutdown();
                 if (transition_from_sleeping()) {
@@ -283,11 +379,35 @@ private:
     uint32_t                               tick_{0};
     std::optional<std::coroutine_handle<>> run_next_{std::nullopt};
     detail::Driver                         driver_;
-    LocalQueue                             local_queue_{};
+    LocalQueue                             local_queue_;
+    // Scratch buffer for batches pulled from the global queue
+    std::vector<std::coroutine_handle<>>   global_batch_;
+    // Workers to steal from, nearest group first
+    std::vector<std::size_t>               steal_order_{};
+    std::vector<std::size_t>               steal_group_ends_{};
     bool                                   is_shutdown_{false};
     bool                                   is_searching_{false};
 };
 
+void Shared::schedule_remote(std::coroutine_handle<> handle) {
+    if (t_worker != nullptr && &t_worker->shared_ == this && t_worker->hand_off(handle)) {
+        return;
+    }
+    global_queue_.push(handle);
+    wake_up_one();
+}
+
+auto Shared::submit_stats() -> detail::SubmitStats {
+    std::lock_guard lock{stats_mutex_};
+    auto            stats = retired_stats_;
+    for (auto driver : drivers_) {
+        if (driver != nullptr) {
+            stats += driver->stats();
+        }
+    }
+    return stats;
+}
+
 void Shared::wake_up_one() {
     if (auto index = idle_.worker_to_notify(); index) {
         LOG_TRACE("Wake up ZEDIO_WORKER_{}", index.value());
@@ -42,6 +42,12 @@ public:
         handle_.schedule_task(task.take());
     }
 
+    /// How many submit syscalls the rings made, and how many the batching saved
+    [[nodiscard]]
+    auto stats() -> SubmitStats {
+        return handle_.stats();
+    }
+
 private:
     Handle handle_;
 };
@@ -2,22 +2,26 @@
 
 // C
 #include <cassert>
+#include <cstdint>
 // C++
-#include <chrono>
 #include <concepts>
 #include <coroutine>
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace zedio::runtime::detail {
 
 class Entry {
 public:
-    Entry(std::chrono::steady_clock::time_point expiration_time, std::coroutine_handle<> handle)
-        : expiration_time_{expiration_time}
+    Entry() = default;
+
+    Entry(uint64_t deadline, std::coroutine_handle<> handle)
+        : deadline_{deadline}
         , handle_{handle} {}
 
-    Entry(std::chrono::steady_clock::time_point expiration_time, io::detail::Callback *data)
-        : expiration_time_{expiration_time}
+    Entry(uint64_t deadline, io::detail::Callback *data)
+        : deadline_{deadline}
         , data_{data} {}
 
 public:
@@ -35,21 +39,63 @@ public:
         }
     }
 
+public:
+    // In ticks since the timer started
+    uint64_t                deadline_{0};
+    std::coroutine_handle<> handle_{nullptr};
+    io::detail::Callback   *data_{nullptr};
+    // Next entry of the same slot, or of the free list
+    Entry                  *next_{nullptr};
+    // Previous entry of the same slot, nullptr for the head
+    Entry                  *prev_{nullptr};
+    // Wheel level holding the entry
+    std::size_t             level_{0};
+};
+
+/// Per worker allocator of timer entries. Entries are carved out of fixed
+/// size blocks and recycled through an intrusive free list, so only growing
+/// the pool touches the heap.
+class EntryPool {
+public:
+    EntryPool() = default;
+
+    // Delete copy
+    EntryPool(const EntryPool &) = delete;
+    auto operator=(const EntryPool &) -> EntryPool & = delete;
+
 public:
     template <class T>
-        requires std::constructible_from<Entry, std::chrono::steady_clock::time_point, T>
+        requires std::constructible_from<Entry, uint64_t, T>
     [[nodiscard]]
-    static auto make(std::chrono::steady_clock::time_point expiration_time, T handle)
-        -> std::pair<std::unique_ptr<Entry>, Entry *> {
-        auto entry = std::make_unique<Entry>(expiration_time, handle);
-        return std::make_pair(std::move(entry), entry.get());
+    auto make(uint64_t deadline, T handle) -> Entry * {
+        if (free_ == nullptr) [[unlikely]] {
+            grow();
+        }
+        auto entry = std::exchange(free_, free_->next_);
+        *entry = Entry{deadline, handle};
+        return entry;
     }
 
-public:
-    std::chrono::steady_clock::time_point expiration_time_;
-    std::coroutine_handle<>               handle_{nullptr};
-    io::detail::Callback                 *data_{nullptr};
-    std::unique_ptr<Entry>                next_{nullptr};
+    void destroy(Entry *entry) noexcept {
+        entry->next_ = free_;
+        free_ = entry;
+    }
+
+private:
+    void grow() {
+        auto &block = blocks_.emplace_back(std::make_unique<Entry[]>(ENTRIES_PER_BLOCK));
+        // Hand out the block front to back
+        for (auto i = ENTRIES_PER_BLOCK; i > 0; i -= 1) {
+            destroy(&block[i - 1]);
+        }
+    }
+
+private:
+    static constexpr std::size_t ENTRIES_PER_BLOCK{256uz};
+
+private:
+    std::vector<std::unique_ptr<Entry[]>> blocks_{};
+    Entry                                *free_{nullptr};
 };
 
 } // namespace zedio::runtime::detail
@@ -1,12 +1,11 @@
 #pragma once
 
 #include "zedio/common/error.hpp"
-#include "zedio/common/static_math.hpp"
-#include "zedio/runtime/timer/util.hpp"
 #include "zedio/runtime/timer/wheel.hpp"
-
 // C++
-#include <variant>
+#include <chrono>
+#include <limits>
+#include <optional>
 
 namespace zedio::runtime::detail {
 
@@ -16,11 +15,25 @@ inline thread_local Timer *t_timer;
 
 class Timer {
 public:
-    Timer() {
+    // Coarsest tick. The furthest deadline, Wheel::MAX_TICKS ticks ahead, has
+    // to fit the nanosecond clock with half of its range left for uptime.
+    static constexpr std::chrono::nanoseconds MAX_RESOLUTION{
+        std::numeric_limits<int64_t>::max() / 2 / static_cast<int64_t>(Wheel::MAX_TICKS)};
+
+public:
+    explicit Timer(std::chrono::nanoseconds tick = std::chrono::milliseconds{1},
+                   bool                     precise = false)
+        : tick_{tick}
+        , precise_{precise} {
+        assert(tick_ > std::chrono::nanoseconds::zero() && tick_ <= MAX_RESOLUTION);
         assert(t_timer == nullptr);
         t_timer = this;
     }
 
+    ~Timer() {
+        t_timer = nullptr;
+    }
+
     // Delete copy
     Timer(const Timer &) = delete;
     auto operator=(const Timer &) -> Timer & = delete;
@@ -29,192 +42,102 @@ public:
     auto operator=(Timer &&) -> Timer & = delete;
 
 public:
+    /// The clock as of the last `update_now`, which the driver calls once per
+    /// poll, so timer operations do not read the clock themselves. It lags by
+    /// up to one round of tasks, precise timers read the clock every time.
+    [[nodiscard]]
+    auto now() const noexcept -> std::chrono::steady_clock::time_point {
+        if (precise_) [[unlikely]] {
+            return std::chrono::steady_clock::now();
+        }
+        return now_;
+    }
+
+    void update_now() noexcept {
+        now_ = std::chrono::steady_clock::now();
+    }
+
     template <class HandleType>
-        requires std::is_invocable_v<decltype(Entry::make<HandleType>),
-                                     std::chrono::steady_clock::time_point,
-                                     HandleType>
+        requires std::constructible_from<Entry, uint64_t, HandleType>
     auto add_entry(std::chrono::steady_clock::time_point expiration_time, HandleType handle)
         -> Result<Entry *> {
-        auto now = std::chrono::steady_clock::now();
-        if (expiration_time <= now) [[unlikely]] {
+        if (expiration_time <= now()) [[unlikely]] {
             return std::unexpected{make_zedio_error(Error::PassedTime)};
         }
-        if (expiration_time >= start_ + std::chrono::milliseconds{MAX_MS}) [[unlikely]] {
+        // Round up, an entry never fires before its expiration time
+        auto ticks = ticks_since_start(expiration_time - std::chrono::nanoseconds{1}) + 1;
+        auto deadline = std::max(ticks, wheel_.elapsed() + 1);
+        if (deadline - wheel_.elapsed() >= Wheel::MAX_TICKS) [[unlikely]] {
             return std::unexpected{make_zedio_error(Error::TooLongTime)};
         }
 
-        auto [entry, result] = Entry::make(expiration_time, handle);
-
-        std::visit(
-            [this, now, &entry]<typename T>(T &wheel) {
-                if constexpr (std::is_same_v<T, std::monostate>) {
-                    start_ = now;
-                    // build main wheel
-                    build_wheel_and_add_entry(std::move(entry),
-                                              time_since_start(entry->expiration_time_));
-                } else {
-                    // level up
-                    level_up_and_add_entry(std::move(wheel),
-                                           std::move(entry),
-                                           time_since_start(entry->expiration_time_));
-                }
-            },
-            root_wheel_);
+        auto entry = pool_.make(deadline, handle);
+        wheel_.insert(entry);
         num_entries_ += 1;
-        return result;
+        return entry;
     }
 
     void remove_entry(Entry *entry) {
-        assert(root_wheel_.index() != 0 && num_entries_ != 0);
-        std::visit(
-            [this, entry]<typename T>(T &wheel) {
-                if constexpr (std::is_same_v<T, std::monostate>) {
-                    std::unreachable();
-                    LOG_ERROR("no entries");
-                } else {
-                    wheel->remove_entry(entry, time_since_start(entry->expiration_time_));
-                    num_entries_ -= 1;
-                    if (num_entries_ == 0) {
-                        root_wheel_ = std::monostate{};
-                    }
-                    //  maybe optimize
-                    //  else {
-                    //  level_down_if_needed(std::move(wheel));
-                    //  }
-                }
-            },
-            root_wheel_);
+        assert(num_entries_ != 0);
+        wheel_.remove(entry);
+        pool_.destroy(entry);
+        num_entries_ -= 1;
     }
 
+    // Time until the wheel has to be polled again
     [[nodiscard]]
-    auto next_expiration_time() -> std::optional<uint64_t> {
-        return std::visit(
-            [this]<typename T>(T &wheel) -> std::optional<uint64_t> {
-                if constexpr (std::is_same_v<T, std::monostate>) {
-                    return std::nullopt;
-                } else {
-                    auto now = std::chrono::steady_clock::now();
-                    return wheel->next_expiration_time() - time_since_start(now);
-                }
-            },
-            root_wheel_);
+    auto next_expiration_time() -> std::optional<std::chrono::nanoseconds> {
+        if (num_entries_ == 0) {
+            return std::nullopt;
+        }
+        auto deadline = wheel_.next_deadline();
+        assert(deadline.has_value());
+        auto remaining = start_ + static_cast<int64_t>(deadline.value()) * tick_ - now();
+        return std::max(remaining, std::chrono::nanoseconds::zero());
     }
 
     template <typename LocalQueue, typename GlobalQueue>
     [[nodiscard]]
     auto handle_expired_entries(LocalQueue &local_queue, GlobalQueue &global_queue) -> std::size_t {
-        if (num_entries_ == 0 || root_wheel_.index() == 0) {
+        if (num_entries_ == 0) {
             return 0uz;
         }
 
-        auto interval = std::chrono::duration_cast<std::chrono::milliseconds>(
-                            std::chrono::steady_clock::now() - start_)
-                            .count();
-
-        assert(interval >= 0);
-
         std::size_t count{0};
 
-        std::visit(
-            [this, &count, &local_queue, &global_queue, interval]<typename T>(T &wheel) {
-                if constexpr (std::is_same_v<T, std::monostate>) {
-                    std::unreachable();
-                } else {
-                    wheel->handle_expired_entries(local_queue,
-                                                  global_queue,
-                                                  count,
-                                                  static_cast<std::size_t>(interval));
-                    num_entries_ -= count;
-                    maintenance(wheel, interval);
-                }
-            },
-            root_wheel_);
+        wheel_.poll(ticks_since_start(now()), [&](Entry *entry) {
+            entry->execute(local_queue, global_queue);
+            pool_.destroy(entry);
+            count += 1;
+        });
+        num_entries_ -= count;
         return count;
     }
 
 private:
-    template <std::size_t LEVEL>
-    void maintenance(std::unique_ptr<Wheel<LEVEL>> &wheel, std::size_t interval) {
-        if (wheel->empty()) {
-            assert(num_entries_ == 0);
-            root_wheel_ = std::monostate{};
-            return;
-        }
-        auto n = interval / Wheel<LEVEL>::MS_PER_SLOT;
-        if (n > 0) {
-            wheel->rotate(n);
-        }
-        start_ += std::chrono::milliseconds{Wheel<LEVEL>::MS_PER_SLOT * n};
-        level_down_if_needed(std::move(wheel));
-    }
-
-    template <std::size_t LEVEL>
-    void level_up_and_add_entry(std::unique_ptr<Wheel<LEVEL>> &&wheel,
-                                std::unique_ptr<Entry>        &&entry,
-                                std::size_t                     interval) {
-        if constexpr (LEVEL == MAX_LEVEL + 1) {
-            assert(false);
-            std::unreachable();
-        } else {
-            if (interval >= Wheel<LEVEL>::MAX_MS) {
-                level_up_and_add_entry(wheel->level_up(std::move(wheel)),
-                                       std::move(entry),
-                                       interval);
-            } else {
-                wheel->add_entry(std::move(entry), interval);
-                root_wheel_ = std::move(wheel);
-            }
-        }
-    }
-
-    template <std::size_t LEVEL = MAX_LEVEL>
-    void build_wheel_and_add_entry(std::unique_ptr<Entry> &&entry, std::size_t interval) {
-        if constexpr (LEVEL > 0uz) {
-            if (!(Wheel<LEVEL>::MS_PER_SLOT <= interval && interval < Wheel<LEVEL>::MAX_MS)) {
-                build_wheel_and_add_entry<LEVEL - 1>(std::move(entry), interval);
-                return;
-            }
-        }
-        auto wheel = std::make_unique<Wheel<LEVEL>>();
-        wheel->add_entry(std::move(entry), interval);
-        root_wheel_ = std::move(wheel);
-    }
-
-    template <std::size_t LEVEL>
-    void level_down_if_needed(std::unique_ptr<Wheel<LEVEL>> &&wheel) {
-        if constexpr (LEVEL > 0) {
-            if (wheel->can_level_down()) {
-                level_down_if_needed(wheel->level_down());
-                return;
-            }
-        }
-        root_wheel_ = std::move(wheel);
-    }
-
     [[nodiscard]]
-    auto time_since_start(std::chrono::steady_clock::time_point expiration_time) -> std::size_t {
-        return std::chrono::duration_cast<std::chrono::milliseconds>(expiration_time - start_)
-            .count();
+    auto ticks_since_start(std::chrono::steady_clock::time_point time_point) -> uint64_t {
+        return static_cast<uint64_t>((time_point - start_) / tick_);
     }
 
 private:
-    //~ 139 years
-    static constexpr std::size_t MAX_MS{util::static_pow(SLOT_SIZE, MAX_LEVEL + 1uz)};
-
-private:
-    std::chrono::steady_clock::time_point      start_{std::chrono::steady_clock::now()};
-    std::size_t                                num_entries_{0};
-    VariantWheelBuilder<MAX_LEVEL + 1uz>::Type root_wheel_{};
-
-    // std::variant<std::monostate,
-    //              std::unique_ptr<Wheel<0>>,
-    //              std::unique_ptr<Wheel<1>>,
-    //              std::unique_ptr<Wheel<2>>,
-    //              std::unique_ptr<Wheel<3>>,
-    //              std::unique_ptr<Wheel<4>>,
-    //              std::unique_ptr<Wheel<5>>,
-    //              std::unique_ptr<Wheel<6>>>
-    //     root_wheel_{};
+    std::chrono::nanoseconds              tick_;
+    bool                                  precise_;
+    std::chrono::steady_clock::time_point start_{std::chrono::steady_clock::now()};
+    std::chrono::steady_clock::time_point now_{start_};
+    std::size_t                           num_entries_{0};
+    EntryPool                             pool_{};
+    Wheel                                 wheel_{};
 };
 
+// The clock as the timer of the current worker sees it, the real clock off
+// the runtime
+[[nodiscard]]
+static inline auto timer_now() -> std::chrono::steady_clock::time_point {
+    if (t_timer == nullptr) [[unlikely]] {
+        return std::chrono::steady_clock::now();
+    }
+    return t_timer->now();
+}
+
 } // namespace zedio::runtime::detail
@@ -1,114 +1,66 @@
 #pragma once
 
-#include "zedio/common/static_math.hpp"
 #include "zedio/runtime/config.hpp"
 #include "zedio/runtime/timer/entry.hpp"
 // C
-#include <assert.h>
+#include <cassert>
 // C++
+#include <algorithm>
 #include <array>
 #include <bit>
+#include <optional>
 
 namespace zedio::runtime::detail {
 
-template <std::size_t LEVEL>
-class Wheel {
-public:
-    using FatherWheel = Wheel<LEVEL + 1>;
-    using FatherWheelPtr = std::unique_ptr<FatherWheel>;
-    using ChildWheel = Wheel<LEVEL - 1>;
-    using ChildWheelPtr = std::unique_ptr<ChildWheel>;
-
+/// One level of the wheel, an occupancy bitmap over doubly linked slot lists
+class Level {
 public:
-    Wheel() {
-        // LOG_DEBUG("build Wheel {}", LEVEL);
-    }
-
-    Wheel(ChildWheelPtr &&child)
-        : bitmap_{1uz}
-        , slots_{std::move(child)} {
-        // LOG_DEBUG("level up from {} to {}", LEVEL - 1, LEVEL);
-    }
-
-    ~Wheel() {
-        // LOG_DEBUG("desc Wheel {}", LEVEL);
-    }
-
-public:
-    void add_entry(std::unique_ptr<Entry> &&entry, std::size_t interval) {
-        std::size_t index = get_index(interval);
-        // LOG_DEBUG("{} {}", index, interval);
-        if (slots_[index] == nullptr) {
-            bitmap_ |= 1uz << index;
-            slots_[index] = std::make_unique<ChildWheel>();
-        }
-        slots_[index]->add_entry(std::move(entry), interval);
-    };
-
-    void remove_entry(Entry *entry, std::size_t interval) {
-        auto index = get_index(interval);
-
-        assert(slots_[index] != nullptr);
-
-        slots_[index]->remove_entry(std::move(entry), interval);
-        if (slots_[index]->empty()) {
-            bitmap_ &= ~(1uz << index);
-            slots_[index] = nullptr;
+    void push(std::size_t slot, Entry *entry) {
+        entry->prev_ = nullptr;
+        entry->next_ = slots_[slot];
+        if (entry->next_ != nullptr) {
+            entry->next_->prev_ = entry;
         }
+        slots_[slot] = entry;
+        bitmap_ |= 1uz << slot;
     }
 
-    template <typename LocalQueue, typename GlobalQueue>
-    void handle_expired_entries(LocalQueue  &local_queue,
-                                GlobalQueue &global_queue,
-                                std::size_t &count,
-                                std::size_t  remaining_ms) {
-        while (bitmap_) {
-            std::size_t index = std::countr_zero(bitmap_);
-            if (index * MS_PER_SLOT > remaining_ms) {
-                break;
-            }
-            slots_[index]->handle_expired_entries(local_queue,
-                                                  global_queue,
-                                                  count,
-                                                  remaining_ms - index * MS_PER_SLOT);
-            if (slots_[index]->empty()) {
-                slots_[index] = nullptr;
-                bitmap_ &= ~(1uz << index);
-            } else {
-                break;
-            }
+    // O(1), the entry knows its neighbours
+    void remove(std::size_t slot, Entry *entry) {
+        if (entry->prev_ != nullptr) {
+            entry->prev_->next_ = entry->next_;
+        } else {
+            assert(slots_[slot] == entry);
+            slots_[slot] = entry->next_;
         }
-    }
-
-    [[nodiscard]]
-    auto next_expiration_time() -> std::size_t {
-        assert(!empty());
-        std::size_t index = std::countr_zero(bitmap_);
-        return index * MS_PER_SLOT + slots_[index]->next_expiration_time();
-    }
-
-    void rotate(std::size_t start) {
-        assert(start < slots_.size());
-        for (auto i = start; i < slots_.size(); i += 1) {
-            assert(slots_[i - start] == nullptr);
-            slots_[i - start] = std::move(slots_[i]);
+        if (entry->next_ != nullptr) {
+            entry->next_->prev_ = entry->prev_;
+        }
+        if (slots_[slot] == nullptr) {
+            bitmap_ &= ~(1uz << slot);
         }
-        bitmap_ >>= start;
     }
 
+    // Detach the whole list of `slot`
     [[nodiscard]]
-    auto level_up(std::unique_ptr<Wheel> &&me) -> FatherWheelPtr {
-        return std::make_unique<FatherWheel>(std::move(me));
+    auto take(std::size_t slot) -> Entry * {
+        bitmap_ &= ~(1uz << slot);
+        return std::exchange(slots_[slot], nullptr);
     }
 
+    // Unlink the head of `slot`
     [[nodiscard]]
-    auto level_down() -> ChildWheelPtr {
-        return std::move(slots_[0]);
+    auto pop(std::size_t slot) -> Entry * {
+        auto entry = slots_[slot];
+        remove(slot, entry);
+        return entry;
     }
 
-    [[nodiscard]]
-    auto can_level_down() const noexcept -> bool {
-        return bitmap_ == 1uz;
+    // Hang a list detached by `take` on `slot`
+    void put(std::size_t slot, Entry *list) {
+        assert(slots_[slot] == nullptr && list->prev_ == nullptr);
+        slots_[slot] = list;
+        bitmap_ |= 1uz << slot;
     }
 
     [[nodiscard]]
@@ -116,126 +68,167 @@ public:
         return bitmap_ == 0;
     }
 
-private:
+    // First occupied slot at or after `slot`, wrapping around
     [[nodiscard]]
-    auto get_index(std::size_t interval) -> std::size_t {
-        return (interval & MASK) >> SHIFT;
+    auto next_occupied(std::size_t slot) const noexcept -> std::optional<std::size_t> {
+        if (bitmap_ == 0) {
+            return std::nullopt;
+        }
+        auto offset = static_cast<std::size_t>(std::countr_zero(std::rotr(bitmap_, slot)));
+        return (slot + offset) % SLOT_SIZE;
     }
 
-public:
-    static constexpr std::size_t SHIFT{LEVEL * 6uz};
-    static constexpr std::size_t MASK{(SLOT_SIZE - 1uz) << SHIFT};
-    static constexpr std::size_t MS_PER_SLOT{util::static_pow(SLOT_SIZE, LEVEL)};
-    static constexpr std::size_t MAX_MS{MS_PER_SLOT * SLOT_SIZE};
-
 private:
-    uint64_t                             bitmap_{0};
-    std::array<ChildWheelPtr, SLOT_SIZE> slots_{};
+    uint64_t                        bitmap_{0};
+    std::array<Entry *, SLOT_SIZE> slots_{};
 };
 
-template <>
-class Wheel<0uz> {
-public:
-    using FatherWheel = Wheel<1>;
-    using FatherWheelPtr = std::unique_ptr<FatherWheel>;
-
+/// Hierarchical timing wheel with every level held inline. Slot `i` of level
+/// `L` holds the entries expiring within the `i`th span of SLOT_SIZE^L ticks
+/// of the current level range. When a slot of an upper level comes due its
+/// entries cascade down to the levels below, so entries fire on their own tick
+/// at any horizon. A poll cascades at most TIMER_CASCADE_BUDGET entries, the
+/// rest of a crowded slot waits for the next polls, which come right away.
+class Wheel {
 public:
-    Wheel() {
-        // LOG_DEBUG("build Wheel {}", 0);
-    }
-
-    ~Wheel() {
-        // LOG_DEBUG("desc Wheel {}", 0);
-    }
+    struct Expiration {
+        std::size_t level_;
+        std::size_t slot_;
+        // First tick covered by the slot
+        uint64_t    deadline_;
+    };
 
 public:
-    void add_entry(std::unique_ptr<Entry> &&entry, std::size_t interval) {
-        auto index = get_index(interval);
-        // LOG_DEBUG("{} {}", index, interval);
-        entry->next_ = std::move(slots_[index]);
-        bitmap_ |= 1uz << index;
-        slots_[index] = std::move(entry);
-    }
-
-    void remove_entry(Entry *entry, std::size_t interval) {
-        auto index = get_index(interval);
-
-        auto head = slots_[index].get();
-        if (head == entry) {
-            slots_[index] = std::move(head->next_);
+    void insert(Entry *entry) {
+        assert(entry->deadline_ > elapsed_);
+        auto level = level_for(entry->deadline_);
+        entry->level_ = level;
+        levels_[level].push(slot_for(entry->deadline_, level), entry);
+    }
+
+    void remove(Entry *entry) {
+        auto slot = slot_for(entry->deadline_, entry->level_);
+        // The slot being cascaded is off the wheel, nothing else can map to it
+        if (!pending_.empty() && entry->level_ == pending_level_ && slot == pending_slot_) {
+            pending_.remove(0, entry);
         } else {
-            auto cur = head->next_.get();
-            // Do not need to check cur != nullptr
-            while (cur != entry) {
-                head = cur;
-                cur = head->next_.get();
-            }
-            assert(cur != nullptr);
-            head->next_ = std::move(cur->next_);
-        }
-        if (slots_[index] == nullptr) {
-            bitmap_ &= ~(1uz << index);
+            levels_[entry->level_].remove(slot, entry);
         }
     }
 
-    template <typename LocalQueue, typename GlobalQueue>
-    void handle_expired_entries(LocalQueue  &local_queue,
-                                GlobalQueue &global_queue,
-                                std::size_t &count,
-                                std::size_t  remaining_ms) {
-        while (bitmap_) {
-            std::size_t index = std::countr_zero(bitmap_);
-            if (index > remaining_ms) {
+    // The tick the wheel has to be polled at next
+    [[nodiscard]]
+    auto next_deadline() const noexcept -> std::optional<uint64_t> {
+        if (!pending_.empty()) {
+            return elapsed_;
+        }
+        return next_expiration().transform([](Expiration e) { return e.deadline_; });
+    }
+
+    /// Advance the wheel towards tick `now`, calling `f` with every entry due
+    template <typename F>
+    void poll(uint64_t now, F &&f) {
+        auto budget = TIMER_CASCADE_BUDGET;
+        while (true) {
+            for (; budget > 0 && !pending_.empty(); budget -= 1) {
+                auto entry = pending_.pop(0);
+                if (entry->deadline_ <= now) {
+                    f(entry);
+                } else {
+                    insert(entry);
+                }
+            }
+            auto expiration = next_expiration();
+            if (!expiration || expiration->deadline_ > now) {
+                break;
+            }
+            // Later slots wait until the crowded one is cascaded
+            if (!pending_.empty() && expiration->level_ >= pending_level_) {
                 break;
             }
-            while (slots_[index] != nullptr) {
-                slots_[index]->execute(local_queue, global_queue);
-                slots_[index] = std::move(slots_[index]->next_);
-                count += 1;
+            auto entry = levels_[expiration->level_].take(expiration->slot_);
+            elapsed_ = expiration->deadline_;
+            if (expiration->level_ > 0 && pending_.empty()) {
+                pending_.put(0, entry);
+                pending_level_ = expiration->level_;
+                pending_slot_ = expiration->slot_;
+                continue;
+            }
+            // Level 0 entries are all due, a slot below the pending one only
+            // holds part of it and is cascaded at once
+            while (entry != nullptr) {
+                // `f` may recycle the entry
+                auto cur = std::exchange(entry, entry->next_);
+                if (cur->deadline_ <= now) {
+                    f(cur);
+                } else {
+                    insert(cur);
+                }
             }
-            bitmap_ &= ~(1uz << index);
+        }
+        if (pending_.empty()) {
+            elapsed_ = std::max(elapsed_, now);
         }
     }
 
     [[nodiscard]]
-    auto next_expiration_time() -> std::size_t {
-        assert(!empty());
-        return std::countr_zero(bitmap_);
-    }
-
-    void rotate(std::size_t start) {
-        assert(start < slots_.size());
-        for (auto i = start; i < slots_.size(); i += 1) {
-            assert(slots_[i - start] == nullptr);
-            slots_[i - start] = std::move(slots_[i]);
-        }
-        bitmap_ >>= start;
+    auto elapsed() const noexcept -> uint64_t {
+        return elapsed_;
     }
 
+private:
+    // The nearest slot holding entries, lower levels always expire first
     [[nodiscard]]
-    auto level_up(std::unique_ptr<Wheel> &&me) -> FatherWheelPtr {
-        return std::make_unique<FatherWheel>(std::move(me));
+    auto next_expiration() const noexcept -> std::optional<Expiration> {
+        for (auto level = 0uz; level < NUM_LEVELS; level += 1) {
+            auto now_slot = slot_for(elapsed_, level);
+            // Only the top level wraps around. Entries of its current range
+            // in the current slot all sit on lower levels, so the ones there
+            // are a full range ahead and that slot comes last.
+            auto top = level == NUM_LEVELS - 1;
+            auto first = top ? (now_slot + 1) % SLOT_SIZE : now_slot;
+            if (auto slot = levels_[level].next_occupied(first); slot) {
+                auto level_range = SLOT_SIZE << (level * SLOT_BITS);
+                auto deadline = (elapsed_ & ~(level_range - 1))
+                                + (slot.value() << (level * SLOT_BITS));
+                if (slot.value() < now_slot || (top && slot.value() == now_slot)) {
+                    deadline += level_range;
+                }
+                return Expiration{level, slot.value(), deadline};
+            }
+        }
+        return std::nullopt;
     }
 
     [[nodiscard]]
-    auto empty() const noexcept -> bool {
-        return bitmap_ == 0;
+    auto level_for(uint64_t deadline) const noexcept -> std::size_t {
+        // The highest bit where the deadline differs from now picks the level
+        auto masked = std::min((elapsed_ ^ deadline) | (SLOT_SIZE - 1), MAX_TICKS - 1);
+        auto significant = static_cast<std::size_t>(std::bit_width(masked)) - 1;
+        return significant / SLOT_BITS;
     }
 
-private:
     [[nodiscard]]
-    auto get_index(std::size_t interval) -> std::size_t {
-        return interval & MASK;
+    static auto slot_for(uint64_t tick, std::size_t level) noexcept -> std::size_t {
+        return static_cast<std::size_t>(tick >> (level * SLOT_BITS)) & (SLOT_SIZE - 1);
     }
 
 public:
-    static constexpr std::size_t MASK{SLOT_SIZE - 1uz};
-    static constexpr std::size_t MS_PER_SLOT{1uz};
-    static constexpr std::size_t MAX_MS{MS_PER_SLOT * SLOT_SIZE};
+    static constexpr std::size_t NUM_LEVELS{MAX_LEVEL + 1uz};
+    static constexpr std::size_t SLOT_BITS{std::countr_zero(SLOT_SIZE)};
+    // How far ahead the wheel can hold entries, ~139 years of millisecond ticks
+    static constexpr uint64_t    MAX_TICKS{1ull << (SLOT_BITS * NUM_LEVELS)};
+
+    static_assert(SLOT_SIZE == 64uz, "slot bitmaps are 64 bits wide");
 
 private:
-    uint64_t                                      bitmap_{0};
-    std::array<std::unique_ptr<Entry>, SLOT_SIZE> slots_{};
+    std::array<Level, NUM_LEVELS> levels_{};
+    // Ticks the wheel has advanced past
+    uint64_t                      elapsed_{0};
+    // The due upper level slot still being cascaded, in slot 0
+    Level                         pending_{};
+    std::size_t                   pending_level_{0};
+    std::size_t                   pending_slot_{0};
 };
 
 } // namespace zedio::runtime::detail
@@ -6,10 +6,14 @@ template <class T, class Addr>
 struct ImplLocalAddr {
     [[nodiscard]]
     auto local_addr() const noexcept -> Result<Addr> {
+        auto fd = static_cast<const T *>(this)->fd();
+        // A fixed file only exists in the ring, plain syscalls can not reach it
+        if (io::is_fixed_file(fd)) [[unlikely]] {
+            return std::unexpected{make_sys_error(EBADF)};
+        }
         Addr      addr{};
         socklen_t len{sizeof(addr)};
-        if (::getsockname(static_cast<const T *>(this)->fd(), addr.sockaddr(), &len) == -1)
-            [[unlikely]] {
+        if (::getsockname(fd, addr.sockaddr(), &len) == -1) [[unlikely]] {
             return std::unexpected{make_sys_error(errno)};
         }
         return addr;
@@ -11,6 +11,10 @@ namespace zedio::socket::detail {
 static inline auto
 set_sock_opt(int fd, int level, int optname, const void *optval, socklen_t optlen) noexcept
     -> Result<void> {
+    // A fixed file only exists in the ring, plain syscalls can not reach it
+    if (io::is_fixed_file(fd)) [[unlikely]] {
+        return std::unexpected{make_sys_error(EBADF)};
+    }
     if (::setsockopt(fd, level, optname, optval, optlen) == -1) [[unlikely]] {
         return std::unexpected{make_sys_error(errno)};
     }
@@ -21,6 +25,9 @@ set_sock_opt(int fd, int level, int optname, const void *optval, socklen_t optle
 static inline auto
 get_sock_opt(int fd, int level, int optname, void *optval, socklen_t optlen) noexcept
     -> Result<void> {
+    if (io::is_fixed_file(fd)) [[unlikely]] {
+        return std::unexpected{make_sys_error(EBADF)};
+    }
     if (auto ret = ::getsockopt(fd, level, optname, optval, &optlen); ret == -1) [[unlikely]] {
         return std::unexpected{make_sys_error(errno)};
     }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "zedio/io/awaiter/recv.hpp"
+#include "zedio/io/awaiter/recv_multishot.hpp"
 #include "zedio/io/impl/impl_async_read.hpp"
 
 namespace zedio::socket::detail {
@@ -14,6 +15,13 @@ struct ImplStreamRead : public io::detail::ImplAsyncRead<T> {
                                 buf.size_bytes(),
                                 MSG_PEEK};
     }
+
+    /// Keep receiving into buffers from the provided buffer ring of the worker,
+    /// see `set_provided_buffers` of the builder
+    [[nodiscard]]
+    auto recv_multishot() const {
+        return io::RecvMultishot{static_cast<const T *>(this)->fd()};
+    }
 };
 
 } // namespace zedio::socket::detail
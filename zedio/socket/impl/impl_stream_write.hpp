@@ -13,6 +13,8 @@ struct ImplStreamWrite {
                                 MSG_NOSIGNAL};
     }
 
+    /// Send without copying `buf` into the kernel, which pays off for large
+    /// buffers. Completes once the kernel is done with `buf`.
     auto write_zc(std::span<const char> buf) noexcept {
         return io::detail::SendZC{static_cast<T *>(this)->fd(),
                                   buf.data(),
@@ -21,6 +23,17 @@ struct ImplStreamWrite {
                                   0};
     }
 
+    /// Like `write_zc`, `buf` must lie in the buffer registered at `buf_index`
+    /// with the ring of the current worker
+    auto write_zc_fixed(std::span<const char> buf, unsigned buf_index) noexcept {
+        return io::detail::SendZCFixed{static_cast<T *>(this)->fd(),
+                                       buf.data(),
+                                       buf.size_bytes(),
+                                       MSG_NOSIGNAL,
+                                       0,
+                                       buf_index};
+    }
+
     template <typename... Ts>
         requires(constructible_to_char_slice<Ts> && ...)
     [[REMEMBER_CO_AWAIT]]
@@ -77,6 +90,22 @@ struct ImplStreamWrite {
         }
         co_return Result<void>{};
     }
+
+    [[REMEMBER_CO_AWAIT]]
+    auto write_zc_all(std::span<const char> buf) noexcept -> zedio::async::Task<Result<void>> {
+        Result<std::size_t> ret{0uz};
+        while (!buf.empty()) {
+            ret = co_await this->write_zc(buf);
+            if (!ret) [[unlikely]] {
+                co_return std::unexpected{ret.error()};
+            }
+            if (ret.value() == 0) [[unlikely]] {
+                co_return std::unexpected{make_zedio_error(Error::WriteZero)};
+            }
+            buf = buf.subspan(ret.value(), buf.size_bytes() - ret.value());
+        }
+        co_return Result<void>{};
+    }
 };
 
 } // namespace zedio::socket::detail
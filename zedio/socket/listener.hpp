@@ -1,5 +1,6 @@
 #pragma once
 
+#include "zedio/io/awaiter/accept_multishot.hpp"
 #include "zedio/socket/impl/impl_local_addr.hpp"
 #include "zedio/socket/socket.hpp"
 
@@ -15,30 +16,24 @@ protected:
 public:
     [[REMEMBER_CO_AWAIT]]
     auto accept() const noexcept {
-        class Accept : public io::detail::IORegistrator<Accept> {
-            using Super = io::detail::IORegistrator<Accept>;
-
-        public:
-            Accept(int fd)
-                : Super{io_uring_prep_accept,
-                        fd,
-                        reinterpret_cast<struct sockaddr *>(&addr_),
-                        &length_,
-                        SOCK_NONBLOCK} {}
-
-            auto await_resume() const noexcept -> Result<std::pair<Stream, Addr>> {
-                if (this->cb_.result_ >= 0) [[likely]] {
-                    return std::make_pair(Stream{Socket{this->cb_.result_}}, addr_);
-                } else {
-                    return std::unexpected{make_sys_error(-this->cb_.result_)};
-                }
-            }
+        return Accept{fd(), false};
+    }
+
+    /// Accept into the fixed file table of the current ring, the stream then
+    /// skips the fd lookup on every operation. Synchronous socket options are
+    /// not available on it. Requires `CurrentThreadBuilder::set_fixed_files`.
+    [[REMEMBER_CO_AWAIT]]
+    auto accept_direct() const noexcept {
+        return Accept{fd(), true};
+    }
 
-        private:
-            Addr      addr_{};
-            socklen_t length_{sizeof(Addr)};
-        };
-        return Accept{fd()};
+    /// A stream of accepted connections backed by one multishot accept. At
+    /// most `max_pending` connections wait for `next()`, then accepting stops
+    /// until the consumer catches up. Peer addresses are not reported, use
+    /// `peer_addr()` of the stream.
+    [[nodiscard]]
+    auto incoming(std::size_t max_pending = 64) const {
+        return Incoming{fd(), max_pending};
     }
 
     [[REMEMBER_CO_AWAIT]]
@@ -80,6 +75,60 @@ public:
         return std::unexpected{make_zedio_error(Error::InvalidAddresses)};
     }
 
+private:
+    class Accept : public io::detail::IORegistrator<Accept> {
+        using Super = io::detail::IORegistrator<Accept>;
+
+    public:
+        Accept(int fd, bool direct)
+            : Super{prep_accept,
+                    fd,
+                    reinterpret_cast<struct sockaddr *>(&addr_),
+                    &length_,
+                    direct}
+            , direct_{direct} {}
+
+        auto await_resume() const noexcept -> Result<std::pair<Stream, Addr>> {
+            if (this->cb_.result_ >= 0) [[likely]] {
+                auto fd = direct_ ? io::make_fixed_file(this->cb_.result_) : this->cb_.result_;
+                return std::make_pair(Stream{Socket{fd}}, addr_);
+            } else {
+                return std::unexpected{make_sys_error(-this->cb_.result_)};
+            }
+        }
+
+    private:
+        static void
+        prep_accept(io_uring_sqe *sqe, int fd, sockaddr *addr, socklen_t *length, bool direct) {
+            if (direct) {
+                io_uring_prep_accept_direct(
+                    sqe, fd, addr, length, SOCK_NONBLOCK, IORING_FILE_INDEX_ALLOC);
+            } else {
+                io_uring_prep_accept(sqe, fd, addr, length, SOCK_NONBLOCK);
+            }
+        }
+
+    private:
+        Addr      addr_{};
+        socklen_t length_{sizeof(Addr)};
+        bool      direct_;
+    };
+
+    class IncomingCallback : public io::detail::AcceptMultishotCallback {
+    public:
+        using io::detail::AcceptMultishotCallback::AcceptMultishotCallback;
+
+        auto take() -> Result<Stream> {
+            auto ret = io::detail::AcceptMultishotCallback::take();
+            if (!ret) [[unlikely]] {
+                return std::unexpected{ret.error()};
+            }
+            return Stream{Socket{ret.value()}};
+        }
+    };
+
+    using Incoming = io::detail::MultishotStream<IncomingCallback>;
+
 private:
     Socket inner_;
 };
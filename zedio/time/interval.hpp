@@ -37,15 +37,15 @@ namespace detail {
         }
 
         void reset() noexcept {
-            expired_time_ = std::chrono::steady_clock::now() + period_;
+            expired_time_ = runtime::detail::timer_now() + period_;
         }
 
         void reset_immediately() noexcept {
-            expired_time_ = std::chrono::steady_clock::now();
+            expired_time_ = runtime::detail::timer_now();
         }
 
         void reset_after(std::chrono::nanoseconds after) noexcept {
-            expired_time_ = std::chrono::steady_clock::now() + after;
+            expired_time_ = runtime::detail::timer_now() + after;
         }
 
         void reset_at(std::chrono::steady_clock::time_point deadline) noexcept {
@@ -63,7 +63,7 @@ namespace detail {
 
     private:
         auto next_timeout() -> std::chrono::steady_clock::time_point {
-            auto now = std::chrono::steady_clock::now();
+            auto now = runtime::detail::timer_now();
             switch (behavior_) {
             case MissedTickBehavior::Burst:
                 return expired_time_ + period_;
@@ -86,7 +86,7 @@ namespace detail {
 } // namespace detail
 
 static inline auto interval(std::chrono::nanoseconds duration) {
-    return detail::Interval{std::chrono::steady_clock::now(), duration};
+    return detail::Interval{runtime::detail::timer_now(), duration};
 }
 
 static inline auto interval_at(std::chrono::steady_clock::time_point start,
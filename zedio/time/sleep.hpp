@@ -46,7 +46,7 @@ namespace detail {
 
 [[REMEMBER_CO_AWAIT]]
 static inline auto sleep(const std::chrono::nanoseconds &duration) {
-    return detail::Sleep{std::chrono::steady_clock::now() + duration};
+    return detail::Sleep{runtime::detail::timer_now() + duration};
 }
 
 [[REMEMBER_CO_AWAIT]]
@@ -1,8 +1,13 @@
 #pragma once
 
+#include "zedio/runtime/io/io_uring.hpp"
 #include "zedio/runtime/timer/timer.hpp"
 // C++
+#include <array>
+#include <chrono>
 #include <concepts>
+// Linux
+#include <liburing.h>
 
 namespace zedio::io::detail {
 template <class T>
@@ -22,7 +27,7 @@ namespace detail {
 
     public:
         auto await_suspend(std::coroutine_handle<> handle) -> bool {
-            assert(this->cb_.entry_ != nullptr);
+            assert(this->cb_.entry_ == nullptr);
 
             auto ret = runtime::detail::t_timer->add_entry(this->cb_.deadline_, &this->cb_);
             if (ret) [[likely]] {
@@ -38,6 +43,36 @@ namespace detail {
         }
     };
 
+    /// The kernel enforces the deadline with an IORING_OP_LINK_TIMEOUT linked
+    /// behind the operation, which then fails with ECANCELED like with
+    /// `Timeout`. Nothing touches the timer wheel and no cancel sqe is needed.
+    template <class T>
+        requires std::derived_from<T, io::detail::IORegistrator<T>>
+    class LinkTimeout : public T {
+    public:
+        LinkTimeout(T &&io, std::chrono::nanoseconds interval)
+            : T{std::move(io)}
+            , ts_{.tv_sec = interval.count() / 1'000'000'000,
+                  .tv_nsec = interval.count() % 1'000'000'000} {
+            auto                           &ring = *runtime::detail::t_ring;
+            std::array<io_uring_sqe *, 2uz> sqes{this->sqe_, ring.get_sqe()};
+            io_uring_prep_link_timeout(sqes[1], &ts_, 0);
+            // Its completion carries nothing the task needs
+            io_uring_sqe_set_data(sqes[1], nullptr);
+            ring.link(sqes, IOSQE_IO_LINK);
+            this->sqe_ = sqes[0];
+        }
+
+        // The sqe points at `ts_` until it is submitted
+        LinkTimeout(const LinkTimeout &) = delete;
+        LinkTimeout(LinkTimeout &&) = delete;
+        auto operator=(const LinkTimeout &) -> LinkTimeout & = delete;
+        auto operator=(LinkTimeout &&) -> LinkTimeout & = delete;
+
+    private:
+        struct __kernel_timespec ts_;
+    };
+
 } // namespace detail
 
 template <class T>
@@ -46,10 +81,16 @@ auto timeout_at(T &&io, std::chrono::steady_clock::time_point deadline) {
     return io.set_timeout_at(deadline);
 }
 
-template <class T>
+template <class T, class Rep, class Period>
     requires std::derived_from<T, io::detail::IORegistrator<T>>
-auto timeout(T &&io, std::chrono::milliseconds interval) {
+auto timeout(T &&io, std::chrono::duration<Rep, Period> interval) {
     return io.set_timeout(interval);
 }
 
+template <class T>
+    requires std::derived_from<T, io::detail::IORegistrator<T>>
+auto link_timeout(T &&io, std::chrono::nanoseconds interval) {
+    return io.set_link_timeout(interval);
+}
+
 } // namespace zedio::time